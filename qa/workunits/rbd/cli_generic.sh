@@ -843,6 +843,42 @@ test_thick_provision() {
     rbd ls | grep test1 | wc -l | grep '^0$'
 }
 
+test_export_sparse() {
+    echo "testing sparse export with fast-diff..."
+    remove_images
+
+    # partial writes to the first, second and last objects, the rest are holes
+    rm -f /tmp/sparse /tmp/sparse.*
+    dd if=/dev/urandom of=/tmp/sparse bs=4K count=1 conv=notrunc
+    dd if=/dev/urandom of=/tmp/sparse bs=4K count=4 seek=1030 conv=notrunc
+    dd if=/dev/urandom of=/tmp/sparse bs=4K count=1 seek=8191 conv=notrunc
+    truncate -s 64M /tmp/sparse
+
+    local features=layering,exclusive-lock,object-map,fast-diff
+    rbd import $RBD_CREATE_ARGS --image-feature $features /tmp/sparse test1
+    rbd import $RBD_CREATE_ARGS --image-feature $features \
+        --stripe-unit 64K --stripe-count 4 /tmp/sparse test2
+
+    for img in test1 test2
+    do
+        rbd export $img /tmp/sparse.$img
+        cmp /tmp/sparse /tmp/sparse.$img
+        cmp <(rbd export $img -) /tmp/sparse.$img
+    done
+
+    rbd snap create test1@snap1
+    rbd export test1@snap1 /tmp/sparse.snap1
+    cmp /tmp/sparse /tmp/sparse.snap1
+
+    # without fast-diff every extent is read and written out
+    rbd feature disable test1 fast-diff
+    rbd export test1 /tmp/sparse.full
+    cmp /tmp/sparse /tmp/sparse.full
+
+    rm -f /tmp/sparse /tmp/sparse.*
+    remove_images
+}
+
 test_namespace() {
     echo "testing namespace..."
     remove_images
@@ -1432,6 +1468,7 @@ test_purge
 test_deep_copy_clone
 test_clone_v2
 test_thick_provision
+test_export_sparse
 test_namespace
 test_trash_purge_schedule
 test_mirror_snapshot_schedule
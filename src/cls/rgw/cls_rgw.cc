@@ -485,6 +485,17 @@ int rgw_bucket_list(cls_method_context_t hctx, bufferlist *in, bufferlist *out)
   // wanting to slow down this op with too many omap reads
   constexpr int max_attempts = 8;
 
+  // when a read ends inside a "subdirectory", the next one seeks past
+  // it; read only a few keys then, as they are likely to start the next
+  // subdirectory and be skipped as well. such seeks do not count as
+  // attempts as long as they add entries, so each one is paid for by an
+  // entry of the result
+  constexpr int prefix_seek_entries = 8;
+
+  // but still bound the omap reads of a single call; the caller picks
+  // up at the returned marker
+  constexpr int max_prefix_seeks = 64;
+
   auto iter = in->cbegin();
 
   rgw_cls_list_op op;
@@ -534,6 +545,8 @@ int rgw_bucket_list(cls_method_context_t hctx, bufferlist *in, bufferlist *out)
   bool done = false;   // whether we need to keep calling get_obj_vals
   bool more = true;    // output parameter of get_obj_vals
   bool has_delimiter = !op.delimiter.empty();
+  bool seeking = false; // last read ended inside a subdirectory
+  int prefix_seeks = 0;
 
   if (has_delimiter &&
       start_after_omap_key > op.filter_prefix &&
@@ -545,18 +558,26 @@ int rgw_bucket_list(cls_method_context_t hctx, bufferlist *in, bufferlist *out)
 
   for (int attempt = 0;
        attempt < max_attempts &&
+	 prefix_seeks < max_prefix_seeks &&
 	 more &&
 	 !done &&
 	 name_entry_map.size() < op.num_entries;
-       ++attempt) {
+       ) {
     std::map<std::string, bufferlist> keys;
 
+    int read_entries = op.num_entries - name_entry_map.size();
+    const bool was_seeking = seeking;
+    if (seeking) {
+      read_entries = std::min(read_entries, prefix_seek_entries);
+      seeking = false;
+    }
+    const size_t prev_size = name_entry_map.size();
+
     // note: get_obj_vals skips past the "ugly namespace" (i.e.,
     // entries that start with the BI_PREFIX_CHAR), so no need to
     // check for such entries
     rc = get_obj_vals(hctx, start_after_omap_key, op.filter_prefix,
-		      op.num_entries - name_entry_map.size(),
-		      &keys, &more);
+		      read_entries, &keys, &more);
     if (rc < 0) {
       return rc;
     }
@@ -566,6 +587,7 @@ int rgw_bucket_list(cls_method_context_t hctx, bufferlist *in, bufferlist *out)
     done = keys.empty();
 
     for (auto kiter = keys.cbegin(); kiter != keys.cend(); ++kiter) {
+      seeking = false;
       rgw_bucket_dir_entry entry;
       try {
 	const bufferlist& entrybl = kiter->second;
@@ -640,6 +662,7 @@ int rgw_bucket_list(cls_method_context_t hctx, bufferlist *in, bufferlist *out)
 	  // advance past this subdirectory, but then back up one,
 	  // so the loop increment will put us in the right place
 	  kiter = keys.lower_bound(start_after_omap_key);
+	  seeking = (kiter == keys.cend());
 	  --kiter;
 
           continue;
@@ -658,6 +681,12 @@ int rgw_bucket_list(cls_method_context_t hctx, bufferlist *in, bufferlist *out)
 		int(name_entry_map.size()));
       }
     } // for (auto kiter...
+
+    if (!was_seeking || name_entry_map.size() == prev_size) {
+      ++attempt;
+    } else {
+      ++prefix_seeks;
+    }
   } // for (int attempt...
 
   ret.is_truncated = more && !done;
@@ -12,7 +12,12 @@
  *
  */
 
+#include <algorithm>
+#include <set>
+
 #include "PriorityCache.h"
+#include "common/admin_socket.h"
+#include "common/errno.h"
 #include "common/dout.h"
 #include "perfglue/heap_profiler.h"
 #define dout_context cct
@@ -58,6 +63,42 @@ namespace PriorityCache
     return val;
   }
 
+  class Manager::SocketHook : public AdminSocketHook {
+    Manager *manager;
+    std::string command;
+  public:
+    SocketHook(Manager *m) : manager(m),
+                             command(m->name + " ratio tuner dump") {}
+
+    int register_command() {
+      AdminSocket *admin_socket = manager->cct->get_admin_socket();
+      if (!admin_socket) {
+        return -ENOENT;
+      }
+      return admin_socket->register_command(
+        command, this,
+        "dump the hit-ratio feedback state used to tune cache ratios");
+    }
+    ~SocketHook() override {
+      AdminSocket *admin_socket = manager->cct->get_admin_socket();
+      if (admin_socket) {
+        admin_socket->unregister_commands(this);
+      }
+    }
+
+    int call(std::string_view cmd, const cmdmap_t& cmdmap,
+             Formatter *f,
+             std::ostream& errss,
+             bufferlist& out) override {
+      if (cmd != command) {
+        errss << "Invalid command" << std::endl;
+        return -ENOSYS;
+      }
+      manager->dump_ratio_tuner(f);
+      return 0;
+    }
+  };
+
   Manager::Manager(CephContext *c,
                    uint64_t min,
                    uint64_t max,
@@ -71,7 +112,8 @@ namespace PriorityCache
       target_mem(target),
       tuned_mem(min),
       reserve_extra(reserve_extra),
-      name(name.empty() ? "prioritycache" : name)
+      name(name.empty() ? "prioritycache" : name),
+      anonymous(name.empty())
   {
     PerfCountersBuilder b(cct, this->name, MallocStats::M_FIRST, MallocStats::M_LAST);
 
@@ -101,8 +143,22 @@ namespace PriorityCache
     tune_memory();
   }
 
+  void Manager::register_ratio_tuner_command()
+  {
+    asok_registered = true;
+    asok_hook = new SocketHook(this);
+    int r = asok_hook->register_command();
+    if (r < 0) {
+      ldout(cct, 1) << __func__ << " cannot register admin socket command: "
+                    << cpp_strerror(r) << dendl;
+      delete asok_hook;
+      asok_hook = nullptr;
+    }
+  }
+
   Manager::~Manager()
   {
+    delete asok_hook;
     clear();
     cct->get_perfcounters_collection()->remove(logger);
     delete logger;
@@ -250,6 +306,9 @@ namespace PriorityCache
     }
     indexes.erase(name);
     caches.erase(name);
+    ratio_tuners.erase(name);
+    std::lock_guard l{ratio_dump_lock};
+    ratio_dump.caches.erase(name);
   }
 
   void Manager::clear()
@@ -262,6 +321,9 @@ namespace PriorityCache
     }
     indexes.clear();
     caches.clear();
+    ratio_tuners.clear();
+    std::lock_guard l{ratio_dump_lock};
+    ratio_dump.caches.clear();
   }
 
   void Manager::balance()
@@ -321,6 +383,153 @@ namespace PriorityCache
     }
   }
 
+  void Manager::tune_ratios(double step, double max_skew)
+  {
+    ceph_assert(step >= 0 && step < 1);
+    ceph_assert(max_skew >= 1);
+
+    if (!asok_registered && !anonymous) {
+      register_ratio_tuner_command();
+    }
+
+    // Sample the counters and measure each cache's misses per byte over the
+    // last interval.  Under the usual concave miss curve the marginal
+    // benefit of extra memory is proportional to that rate, so equalizing
+    // it across caches minimizes total misses for a given budget.
+    double total_base = 0;
+    ratio_tuner_t *most = nullptr, *least = nullptr;
+    std::string most_name, least_name;
+    for (auto& [cname, c] : caches) {
+      auto& t = ratio_tuners[cname];
+      t.base_ratio = c->get_cache_ratio();
+      total_base += t.base_ratio;
+
+      uint64_t hits, misses;
+      if (!c->get_hit_stats(&hits, &misses)) {
+        t.weight = 1.0;
+        t.utility = 0;
+        continue;
+      }
+      if (!t.primed || hits < t.last_hits || misses < t.last_misses) {
+        // first sample, or the counters were reset
+        t.last_hits = hits;
+        t.last_misses = misses;
+        t.primed = true;
+        continue;
+      }
+      t.interval_hits = hits - t.last_hits;
+      t.interval_misses = misses - t.last_misses;
+      t.last_hits = hits;
+      t.last_misses = misses;
+
+      // a cache nobody is configured to give memory to is left alone
+      if (t.base_ratio <= 0) {
+        t.utility = 0;
+        continue;
+      }
+      int64_t bytes = std::max<int64_t>(c->get_committed_size(),
+                                        get_chunk(1, tuned_mem));
+      t.utility = (double)t.interval_misses / bytes;
+      if (!most || t.utility > most->utility) {
+        most = &t;
+        most_name = cname;
+      }
+      if (!least || t.utility < least->utility) {
+        least = &t;
+        least_name = cname;
+      }
+    }
+
+    if (most && least && most != least && most->utility > least->utility) {
+      most->weight = std::min(most->weight * (1 + step), max_skew);
+      least->weight = std::max(least->weight * (1 - step), 1 / max_skew);
+      last_ratio_move = least_name + " -> " + most_name;
+      ldout(cct, 5) << __func__ << " moving memory from " << least_name
+                    << " (" << least->utility << " misses/byte) to "
+                    << most_name << " (" << most->utility << " misses/byte)"
+                    << dendl;
+    } else {
+      last_ratio_move.clear();
+    }
+    ++ratio_tune_rounds;
+
+    // Apply the weights, keeping the sum of the ratios unchanged.  The
+    // renormalization can push a ratio past max_skew of its base, so pin
+    // those at the bound and spread what is left over the others.  Every
+    // pass pins at least one cache or ends the loop.
+    std::set<std::string> pinned;
+    double pinned_total = 0;
+    for (bool repin = true; repin; ) {
+      repin = false;
+      double total_weighted = 0;
+      for (auto& [cname, c] : caches) {
+        if (!pinned.count(cname)) {
+          auto& t = ratio_tuners[cname];
+          total_weighted += t.base_ratio * t.weight;
+        }
+      }
+      for (auto& [cname, c] : caches) {
+        if (pinned.count(cname)) {
+          continue;
+        }
+        auto& t = ratio_tuners[cname];
+        double ratio = total_weighted > 0 ?
+          t.base_ratio * t.weight * (total_base - pinned_total) /
+          total_weighted : t.base_ratio;
+        t.tuned_ratio = std::clamp(ratio, t.base_ratio / max_skew,
+                                   t.base_ratio * max_skew);
+        if (t.tuned_ratio != ratio) {
+          pinned.insert(cname);
+          pinned_total += t.tuned_ratio;
+          repin = true;
+        }
+      }
+    }
+    for (auto& [cname, c] : caches) {
+      auto& t = ratio_tuners[cname];
+      c->set_cache_ratio(t.tuned_ratio);
+      t.committed = c->get_committed_size();
+      ldout(cct, 10) << __func__ << " " << cname
+                     << " hits: " << t.interval_hits
+                     << " misses: " << t.interval_misses
+                     << " utility: " << t.utility
+                     << " weight: " << t.weight
+                     << " ratio: " << t.base_ratio
+                     << " -> " << t.tuned_ratio << dendl;
+    }
+
+    std::lock_guard l{ratio_dump_lock};
+    ratio_dump.rounds = ratio_tune_rounds;
+    ratio_dump.last_move = last_ratio_move;
+    ratio_dump.tuned_mem = tuned_mem;
+    ratio_dump.caches.clear();
+    ratio_dump.caches.insert(ratio_tuners.begin(), ratio_tuners.end());
+  }
+
+  void Manager::dump_ratio_tuner(ceph::Formatter *f) const
+  {
+    std::lock_guard l{ratio_dump_lock};
+    f->open_object_section("ratio_tuner");
+    f->dump_unsigned("rounds", ratio_dump.rounds);
+    f->dump_string("last_move", ratio_dump.last_move);
+    f->dump_unsigned("tuned_mem", ratio_dump.tuned_mem);
+    f->open_array_section("caches");
+    for (auto& [cname, t] : ratio_dump.caches) {
+      f->open_object_section("cache");
+      f->dump_string("name", cname);
+      f->dump_unsigned("interval_hits", t.interval_hits);
+      f->dump_unsigned("interval_misses", t.interval_misses);
+      f->dump_float("misses_per_byte", t.utility);
+      f->dump_float("weight", t.weight);
+      f->dump_float("base_ratio", t.base_ratio);
+      f->dump_float("tuned_ratio", t.tuned_ratio);
+      f->dump_int("committed_bytes", t.committed);
+      f->close_section();
+    }
+    f->close_section();
+    f->close_section();
+  }
+
   void Manager::balance_priority(int64_t *mem_avail, Priority pri)
   {
     std::unordered_map<std::string, std::shared_ptr<PriCache>> tmp_caches = caches;
@@ -16,10 +16,13 @@
 #define CEPH_PRIORITY_CACHE_H
 
 #include <stdint.h>
+#include <map>
 #include <string>
 #include <vector>
 #include <memory>
 #include <unordered_map>
+#include "common/ceph_mutex.h"
+#include "common/Formatter.h"
 #include "common/perf_counters.h"
 #include "include/ceph_assert.h"
 
@@ -112,6 +115,13 @@ namespace PriorityCache {
 
     // Get bins
     virtual uint64_t get_bins(PriorityCache::Priority pri) const = 0;
+
+    /* Get cumulative lookup hit/miss counts.  Used by Manager::tune_ratios()
+     * to estimate which cache benefits most from extra memory.  Caches that
+     * don't track them return false and keep their configured ratio. */
+    virtual bool get_hit_stats(uint64_t *hits, uint64_t *misses) const {
+      return false;
+    }
   };
 
   class Manager {
@@ -130,6 +140,46 @@ namespace PriorityCache {
     uint64_t tuned_mem = 0;
     bool reserve_extra;
     std::string name;
+    // no name was given, so there is nothing to key an admin socket command on
+    const bool anonymous;
+
+    // Hit-ratio feedback state for tune_ratios().  weight scales the ratio
+    // the cache was configured with; utility is the last measured miss count
+    // per byte of cache, our estimate of the marginal benefit of more memory.
+    struct ratio_tuner_t {
+      uint64_t last_hits = 0;
+      uint64_t last_misses = 0;
+      uint64_t interval_hits = 0;
+      uint64_t interval_misses = 0;
+      double base_ratio = 0;
+      double tuned_ratio = 0;
+      double weight = 1.0;
+      double utility = 0;
+      int64_t committed = 0;
+      bool primed = false;
+    };
+    std::unordered_map<std::string, ratio_tuner_t> ratio_tuners;
+    uint64_t ratio_tune_rounds = 0;
+    std::string last_ratio_move;
+
+    // Copy of the tuner state published at the end of each tune_ratios()
+    // round.  The admin socket dumps this instead of walking the containers
+    // that tune_ratios(), insert() and erase() modify.
+    struct ratio_tuner_dump_t {
+      uint64_t rounds = 0;
+      std::string last_move;
+      uint64_t tuned_mem = 0;
+      std::map<std::string, ratio_tuner_t> caches;
+    };
+    mutable ceph::mutex ratio_dump_lock =
+      ceph::make_mutex("PriorityCache::Manager::ratio_dump_lock");
+    ratio_tuner_dump_t ratio_dump;
+
+    // registered by the first tune_ratios() call of a named manager
+    class SocketHook;
+    SocketHook *asok_hook = nullptr;
+    bool asok_registered = false;
+    void register_ratio_tuner_command();
   public:
     Manager(CephContext *c, uint64_t min, uint64_t max, uint64_t target,
             bool reserve_extra, const std::string& name = std::string());
@@ -153,6 +203,14 @@ namespace PriorityCache {
     void tune_memory();
     void balance();
     void shift_bins();
+
+    /* Adjust each cache's ratio based on the hit/miss counts it reported
+     * since the previous call.  Memory shifts by step (a fraction of the
+     * ratio) from the cache with the fewest misses per byte to the one with
+     * the most, within max_skew of the configured ratio.  Call after the
+     * configured ratios have been set and before balance(). */
+    void tune_ratios(double step, double max_skew);
+    void dump_ratio_tuner(ceph::Formatter *f) const;
   private:
     void balance_priority(int64_t *mem_avail, Priority pri);
   };
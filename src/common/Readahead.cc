@@ -11,12 +11,7 @@ Readahead::Readahead()
     m_readahead_min_bytes(0),
     m_readahead_max_bytes(NO_LIMIT),
     m_alignments(),
-    m_nr_consec_read(0),
-    m_consec_read_bytes(0),
-    m_last_pos(0),
-    m_readahead_pos(0),
-    m_readahead_trigger_pos(0),
-    m_readahead_size(0),
+    m_streams(1),
     m_pending(0) {
 }
 
@@ -28,63 +23,87 @@ Readahead::extent_t Readahead::update(const vector<extent_t>& extents, uint64_t
   for (vector<extent_t>::const_iterator p = extents.begin(); p != extents.end(); ++p) {
     _observe_read(p->first, p->second);
   }
-  if (m_readahead_pos >= limit|| m_last_pos >= limit) {
+  stream_t &stream = m_streams[m_last_stream];
+  if (stream.readahead_pos >= limit|| stream.last_pos >= limit) {
     m_lock.unlock();
     return extent_t(0, 0);
   }
-  std::pair<uint64_t, uint64_t> extent = _compute_readahead(limit);
+  std::pair<uint64_t, uint64_t> extent = _compute_readahead(stream, limit);
   m_lock.unlock();
   return extent;
 }
 
 Readahead::extent_t Readahead::update(uint64_t offset, uint64_t length, uint64_t limit) {
   m_lock.lock();
-  _observe_read(offset, length);
-  if (m_readahead_pos >= limit || m_last_pos >= limit) {
+  stream_t &stream = _observe_read(offset, length);
+  if (stream.readahead_pos >= limit || stream.last_pos >= limit) {
     m_lock.unlock();
     return extent_t(0, 0);
   }
-  extent_t extent = _compute_readahead(limit);
+  extent_t extent = _compute_readahead(stream, limit);
   m_lock.unlock();
   return extent;
 }
 
-void Readahead::_observe_read(uint64_t offset, uint64_t length) {
-  if (offset == m_last_pos) {
-    m_nr_consec_read++;
-    m_consec_read_bytes += length;
+Readahead::stream_t &Readahead::_observe_read(uint64_t offset, uint64_t length) {
+  size_t idx = 0;
+  for (size_t i = 0; i < m_streams.size(); ++i) {
+    if (m_streams[i].last_pos == offset) {
+      idx = i;
+      break;
+    }
+    if (m_streams[i].last_access < m_streams[idx].last_access) {
+      idx = i;
+    }
+  }
+
+  stream_t &stream = m_streams[idx];
+  if (offset == stream.last_pos) {
+    stream.nr_consec_read++;
+    stream.consec_read_bytes += length;
+    if (stream.readahead_pos > offset) {
+      m_prefetch_stats.useful_bytes +=
+	std::min(length, stream.readahead_pos - offset);
+    }
   } else {
-    m_nr_consec_read = 0;
-    m_consec_read_bytes = 0;
-    m_readahead_trigger_pos = 0;
-    m_readahead_size = 0;
-    m_readahead_pos = 0;
+    // no stream continues at this offset: replace the least recently used one
+    if (stream.readahead_pos > stream.last_pos) {
+      m_prefetch_stats.wasted_bytes += stream.readahead_pos - stream.last_pos;
+    }
+    stream.nr_consec_read = 0;
+    stream.consec_read_bytes = 0;
+    stream.readahead_trigger_pos = 0;
+    stream.readahead_size = 0;
+    stream.readahead_pos = 0;
   }
-  m_last_pos = offset + length;
+  stream.last_pos = offset + length;
+  stream.last_access = ++m_access_seq;
+  m_last_stream = idx;
+  return stream;
 }
 
-Readahead::extent_t Readahead::_compute_readahead(uint64_t limit) {
+Readahead::extent_t Readahead::_compute_readahead(stream_t &stream, uint64_t limit) {
   uint64_t readahead_offset = 0;
   uint64_t readahead_length = 0;
-  if (m_nr_consec_read >= m_trigger_requests) {
+  if (stream.nr_consec_read >= m_trigger_requests) {
     // currently reading sequentially
-    if (m_last_pos >= m_readahead_trigger_pos) {
+    if (stream.last_pos >= stream.readahead_trigger_pos) {
       // need to read ahead
-      if (m_readahead_size == 0) {
+      if (stream.readahead_size == 0) {
 	// initial readahead trigger
-	m_readahead_size = m_consec_read_bytes;
-	m_readahead_pos = m_last_pos;
+	stream.readahead_size = stream.consec_read_bytes;
+	stream.readahead_pos = stream.last_pos;
       } else {
 	// continuing readahead trigger
-	m_readahead_size *= 2;
-	if (m_last_pos > m_readahead_pos) {
-	  m_readahead_pos = m_last_pos;
+	stream.readahead_size *= 2;
+	if (stream.last_pos > stream.readahead_pos) {
+	  stream.readahead_pos = stream.last_pos;
 	}
       }
-      m_readahead_size = std::max(m_readahead_size, m_readahead_min_bytes);
-      m_readahead_size = std::min(m_readahead_size, m_readahead_max_bytes);
-      readahead_offset = m_readahead_pos;
-      readahead_length = m_readahead_size;
+      stream.readahead_size = std::max(stream.readahead_size, m_readahead_min_bytes);
+      stream.readahead_size = std::min(stream.readahead_size, m_readahead_max_bytes);
+      readahead_offset = stream.readahead_pos;
+      readahead_length = stream.readahead_size;
 
       // Snap to the first alignment possible
       uint64_t readahead_end = readahead_offset + readahead_length;
@@ -106,15 +125,15 @@ Readahead::extent_t Readahead::_compute_readahead(uint64_t limit) {
 	  readahead_length = align_next - readahead_offset;
 	  break;
 	}
-	// Note that m_readahead_size should remain unadjusted.
+	// Note that stream.readahead_size should remain unadjusted.
       }
 
-      if (m_readahead_pos + readahead_length > limit) {
-	readahead_length = limit - m_readahead_pos;
+      if (stream.readahead_pos + readahead_length > limit) {
+	readahead_length = limit - stream.readahead_pos;
       }
 
-      m_readahead_trigger_pos = m_readahead_pos + readahead_length / 2;
-      m_readahead_pos += readahead_length;
+      stream.readahead_trigger_pos = stream.readahead_pos + readahead_length / 2;
+      stream.readahead_pos += readahead_length;
     }
   }
   return extent_t(readahead_offset, readahead_length);
@@ -161,6 +180,22 @@ void Readahead::wait_for_pending(Context *ctx) {
 
   ctx->complete(0);
 }
+Readahead::prefetch_stats_t Readahead::pop_prefetch_stats() {
+  std::lock_guard lock(m_lock);
+  prefetch_stats_t stats = m_prefetch_stats;
+  m_prefetch_stats = prefetch_stats_t();
+  return stats;
+}
+
+void Readahead::set_max_streams(unsigned max_streams) {
+  ceph_assert(max_streams > 0);
+  std::lock_guard lock(m_lock);
+  m_streams.resize(max_streams);
+  if (m_last_stream >= max_streams) {
+    m_last_stream = 0;
+  }
+}
+
 void Readahead::set_trigger_requests(int trigger_requests) {
   m_lock.lock();
   m_trigger_requests = trigger_requests;
@@ -15,6 +15,9 @@
    on linear things such as RBD images or files.
    Unless otherwise specified, all methods are thread-safe.
 
+   Up to \c max_streams independent sequential streams are tracked. A read that does not
+   continue any of them replaces the least recently used stream.
+
    Minimum and maximum readahead sizes may be violated by up to 50\% if alignment is enabled.
    Minimum readahead size may be violated if the end of the readahead target is reached.
  */
@@ -22,6 +25,13 @@ class Readahead {
 public:
   typedef std::pair<uint64_t, uint64_t> extent_t;
 
+  struct prefetch_stats_t {
+    /// Prefetched bytes that were subsequently read
+    uint64_t useful_bytes = 0;
+    /// Prefetched bytes that were still unread when their stream was replaced
+    uint64_t wasted_bytes = 0;
+  };
+
   // equal to UINT64_MAX
   static const uint64_t NO_LIMIT = 18446744073709551615ULL;
 
@@ -75,6 +85,16 @@ public:
   void wait_for_pending();
   void wait_for_pending(Context *ctx);
 
+  /**
+     Returns the prefetch accounting since the last call and resets it.
+   */
+  prefetch_stats_t pop_prefetch_stats();
+
+  /**
+     Sets the number of sequential streams tracked concurrently.
+   */
+  void set_max_streams(unsigned max_streams);
+
   /**
      Sets the number of sequential requests necessary to trigger readahead.
    */
@@ -109,17 +129,40 @@ public:
   void set_alignments(const std::vector<uint64_t> &alignments);
 
 private:
+  struct stream_t {
+    /// Number of consecutive read requests in the sequential stream
+    int nr_consec_read = 0;
+
+    /// Number of bytes read in the sequential stream
+    uint64_t consec_read_bytes = 0;
+
+    /// Position of the read stream
+    uint64_t last_pos = 0;
+
+    /// Position of the readahead stream
+    uint64_t readahead_pos = 0;
+
+    /// When readahead is already triggered and the read stream crosses this point, readahead is continued
+    uint64_t readahead_trigger_pos = 0;
+
+    /// Size of the next readahead request (barring changes due to alignment, etc.)
+    uint64_t readahead_size = 0;
+
+    /// Value of m_access_seq when the stream was last read
+    uint64_t last_access = 0;
+  };
+
   /**
-     Records that a read request has been received.
+     Records that a read request has been received and returns the stream it belongs to.
      m_lock must be held while calling.
    */
-  void _observe_read(uint64_t offset, uint64_t length);
+  stream_t &_observe_read(uint64_t offset, uint64_t length);
 
   /**
-     Computes the next readahead request.
+     Computes the next readahead request for a stream.
      m_lock must be held while calling.
   */
-  extent_t _compute_readahead(uint64_t limit);
+  extent_t _compute_readahead(stream_t &stream, uint64_t limit);
 
   /// Number of sequential requests necessary to trigger readahead
   int m_trigger_requests;
@@ -136,23 +179,17 @@ private:
   /// Held while reading/modifying any state except m_pending
   ceph::mutex m_lock = ceph::make_mutex("Readahead::m_lock");
 
-  /// Number of consecutive read requests in the current sequential stream
-  int m_nr_consec_read;
-
-  /// Number of bytes read in the current sequenial stream
-  uint64_t m_consec_read_bytes;
-
-  /// Position of the read stream
-  uint64_t m_last_pos;
+  /// Tracked sequential streams
+  std::vector<stream_t> m_streams;
 
-  /// Position of the readahead stream
-  uint64_t m_readahead_pos;
+  /// Index of the stream touched by the most recent read
+  size_t m_last_stream = 0;
 
-  /// When readahead is already triggered and the read stream crosses this point, readahead is continued
-  uint64_t m_readahead_trigger_pos;
+  /// Incremented on every observed read to order streams by recency
+  uint64_t m_access_seq = 0;
 
-  /// Size of the next readahead request (barring changes due to alignment, etc.)
-  uint64_t m_readahead_size;
+  /// Prefetch accounting since the last pop_prefetch_stats()
+  prefetch_stats_t m_prefetch_stats;
 
   /// Number of pending readahead requests, as determined by inc_pending() and dec_pending()
   int m_pending;
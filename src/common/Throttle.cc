@@ -4,7 +4,9 @@
 #include "include/scope_guard.h"
 
 #include "common/Throttle.h"
+#include "common/ceph_context.h"
 #include "common/ceph_time.h"
+#include "common/Finisher.h"
 #include "common/perf_counters.h"
 
 
@@ -742,6 +744,24 @@ void TokenBucketThrottle::Bucket::set_max(uint64_t max, uint64_t burst_seconds)
   this->max = max;
 }
 
+namespace {
+
+struct TokenBucketResumeFinisher {
+  Finisher *finisher;
+
+  explicit TokenBucketResumeFinisher(CephContext *cct) {
+    finisher = new Finisher(cct, "TokenBucketThrottle::resume", "tb_resume");
+    finisher->start();
+  }
+  ~TokenBucketResumeFinisher() {
+    finisher->wait_for_empty();
+    finisher->stop();
+    delete finisher;
+  }
+};
+
+} // anonymous namespace
+
 TokenBucketThrottle::TokenBucketThrottle(
     CephContext *cct,
     const std::string &name,
@@ -752,10 +772,20 @@ TokenBucketThrottle::TokenBucketThrottle(
   : m_cct(cct), m_name(name),
     m_throttle(m_cct, name + "_bucket", burst),
     m_burst(burst), m_avg(avg), m_timer(timer), m_timer_lock(timer_lock),
-    m_lock(ceph::make_mutex(name + "_lock"))
+    m_lock(ceph::make_mutex(name + "_lock")),
+    m_resume_finisher(cct->lookup_or_create_singleton_object<
+      TokenBucketResumeFinisher>("common::TokenBucketThrottle::resume_finisher",
+                                 false, cct).finisher),
+    m_resume_ref(std::make_shared<ResumeRef>(this))
 {}
 
 TokenBucketThrottle::~TokenBucketThrottle() {
+  // a restart still queued on the finisher must not touch us
+  {
+    std::lock_guard ref_locker{m_resume_ref->lock};
+    m_resume_ref->throttle = nullptr;
+  }
+
   // cancel the timer events.
   {
     std::lock_guard timer_locker(*m_timer_lock);
@@ -839,8 +869,9 @@ uint64_t TokenBucketThrottle::tokens_this_tick() {
   return tokens_filled(m_current_tick) - tokens_filled(m_current_tick - 1);
 }
 
-void TokenBucketThrottle::add_tokens() {
+bool TokenBucketThrottle::add_tokens() {
   list<Blocker> tmp_blockers;
+  bool idle;
   {
     std::lock_guard lock(m_lock);
     // put tokens into bucket.
@@ -865,23 +896,54 @@ void TokenBucketThrottle::add_tokens() {
         break;
       }
     }
+
+    // further ticks cannot change anything until tokens are taken again
+    idle = m_blockers.empty() &&
+           (0 == m_avg || 0 == m_throttle.max ||
+            (m_throttle.remain == m_throttle.capacity &&
+             m_throttle.available == m_throttle.max));
+    m_idle = idle;
   }
 
   for (auto b : tmp_blockers) {
     b.ctx->complete(0);
   }
+  return idle;
 }
 
 void TokenBucketThrottle::schedule_timer() {
+  if (add_tokens()) {
+    // stop ticking while idle so that many mostly idle throttles sharing a
+    // timer do not keep it busy; get() resumes it
+    m_token_ctx = nullptr;
+    return;
+  }
+
   m_token_ctx = new LambdaContext(
       [this](int r) {
         schedule_timer();
       });
   m_timer->add_event_after(m_schedule_tick, m_token_ctx);
+}
 
-  add_tokens();
+void TokenBucketThrottle::resume_timer() {
+  m_resume_finisher->queue(new LambdaContext(
+    [ref = m_resume_ref](int r) {
+      std::lock_guard ref_locker{ref->lock};
+      auto throttle = ref->throttle;
+      if (throttle == nullptr) {
+        return;
+      }
+      std::lock_guard timer_locker{*throttle->m_timer_lock};
+      if (throttle->m_token_ctx == nullptr) {
+        throttle->schedule_timer();
+      }
+    }));
 }
 
 void TokenBucketThrottle::cancel_timer() {
-  m_timer->cancel_event(m_token_ctx);
+  if (m_token_ctx != nullptr) {
+    m_timer->cancel_event(m_token_ctx);
+    m_token_ctx = nullptr;
+  }
 }
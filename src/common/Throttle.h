@@ -9,6 +9,7 @@
 #include <iostream>
 #include <list>
 #include <map>
+#include <memory>
 
 #include "common/ceph_mutex.h"
 #include "include/Context.h"
@@ -332,6 +333,8 @@ private:
 };
 
 
+class Finisher;
+
 class TokenBucketThrottle {
   struct Bucket {
     CephContext *cct;
@@ -369,6 +372,20 @@ class TokenBucketThrottle {
   std::list<Blocker> m_blockers;
   ceph::mutex m_lock;
 
+  // the bucket is full and nothing is blocked, so the refill timer has been
+  // stopped until tokens are taken again. protected by m_lock.
+  bool m_idle = false;
+
+  // restarts of a stopped timer are queued here rather than done in get()
+  Finisher *m_resume_finisher;
+  // lets a queued restart find out whether the throttle is gone
+  struct ResumeRef {
+    ceph::mutex lock = ceph::make_mutex("TokenBucketThrottle::ResumeRef::lock");
+    TokenBucketThrottle *throttle;
+    explicit ResumeRef(TokenBucketThrottle *throttle) : throttle(throttle) {}
+  };
+  std::shared_ptr<ResumeRef> m_resume_ref;
+
   // minimum of the filling period.
   uint64_t m_tick_min = 50;
   // tokens filling period, its unit is millisecond.
@@ -428,30 +445,45 @@ public:
     m_blockers.emplace_back(c, ctx);
   }
 
+  // get() never takes the timer lock, so it may be called with the timer
+  // lock held, or with a lock that the blocker callbacks also take.  Those
+  // callbacks run from the timer with the timer lock held; restarting an
+  // idle timer is therefore handed to a finisher.
   template <typename T, typename MF, typename I>
   bool get(uint64_t c, T&& t, MF&& mf, I&& item, uint64_t flag) {
     bool wait = false;
+    bool resume = false;
     uint64_t got = 0;
-    std::lock_guard lock(m_lock);
-    if (!m_blockers.empty()) {
-      // Keep the order of requests, add item after previous blocked requests.
-      wait = true;
-    } else {
-      if (0 == m_throttle.max || 0 == m_avg)
-        return false;
-
-      got = m_throttle.get(c);
-      if (got < c) {
-        // Not enough tokens, add a blocker for it.
+    {
+      std::lock_guard lock(m_lock);
+      if (!m_blockers.empty()) {
+        // Keep the order of requests, add item after previous blocked requests.
         wait = true;
+      } else {
+        if (0 == m_throttle.max || 0 == m_avg)
+          return false;
+
+        got = m_throttle.get(c);
+        if (got < c) {
+          // Not enough tokens, add a blocker for it.
+          wait = true;
+        }
       }
-    }
 
-    if (wait) {
-      add_blocker(c - got, std::forward<T>(t), std::forward<MF>(mf),
-                  std::forward<I>(item), flag);
+      if (wait) {
+        add_blocker(c - got, std::forward<T>(t), std::forward<MF>(mf),
+                    std::forward<I>(item), flag);
+      }
+
+      if (m_idle && (wait || got > 0)) {
+        m_idle = false;
+        resume = true;
+      }
     }
 
+    if (resume) {
+      resume_timer();
+    }
     return wait;
   }
 
@@ -461,8 +493,9 @@ public:
 private:
   uint64_t tokens_filled(double tick);
   uint64_t tokens_this_tick();
-  void add_tokens();
+  bool add_tokens();
   void schedule_timer();
+  void resume_timer();
   void cancel_timer();
 };
 
@@ -60,6 +60,12 @@ namespace TOPNSPC::crypto {
 	void Restart();
 	void SetFlags(int flags);
 	void Update (const unsigned char *input, size_t length);
+	// hash each segment in place rather than flattening the list
+	void Update (const ceph::buffer::list& bl) {
+	  for (auto& p : bl.buffers()) {
+	    Update((const unsigned char *)p.c_str(), p.length());
+	  }
+	}
 	void Final (unsigned char *digest);
     };
 
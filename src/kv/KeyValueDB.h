@@ -4,11 +4,13 @@
 #define KEY_VALUE_DB_H
 
 #include "include/buffer.h"
+#include <functional>
 #include <ostream>
 #include <set>
 #include <map>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <boost/scoped_ptr.hpp>
 #include "include/encoding.h"
 #include "common/Formatter.h"
@@ -51,6 +53,34 @@ public:
       }
     }
 
+    /// Set a sorted run of keys sharing a common leading part
+    ///
+    /// @p p points at the same count + key/value encoding as above; each
+    /// value is stored under key_base + key.  Backends may override this to
+    /// do the per-prefix work (CF lookup, key assembly) once per run.
+    ///
+    /// @returns the number of keys set
+    virtual uint32_t set_run(
+      const std::string &prefix,      ///< [in] prefix, or CF name
+      const std::string &key_base,    ///< [in] common leading part of the keys
+      ceph::buffer::list::const_iterator& p ///< [in] encoded key/values
+      ) {
+      using ceph::decode;
+      uint32_t num;
+      decode(num, p);
+      std::string final_key = key_base;
+      for (uint32_t i = 0; i < num; ++i) {
+	std::string key;
+	ceph::buffer::list value;
+	decode(key, p);
+	decode(value, p);
+	final_key.resize(key_base.size());
+	final_key += key;
+	set(prefix, final_key, value);
+      }
+      return num;
+    }
+
     /// Set Key
     virtual void set(
       const std::string &prefix,      ///< [in] Prefix or CF for the key
@@ -81,6 +111,31 @@ public:
       }
     }
 
+    /// Removes a sorted run of keys sharing a common leading part
+    ///
+    /// @p p points at the same count + key encoding as above; each key
+    /// removed is key_base + key.
+    ///
+    /// @returns the number of keys removed
+    virtual uint32_t rmkeys_run(
+      const std::string &prefix,     ///< [in] Prefix or CF to search for
+      const std::string &key_base,   ///< [in] common leading part of the keys
+      ceph::buffer::list::const_iterator& p ///< [in] encoded keys
+    ) {
+      using ceph::decode;
+      uint32_t num;
+      decode(num, p);
+      std::string final_key = key_base;
+      for (uint32_t i = 0; i < num; ++i) {
+	std::string key;
+	decode(key, p);
+	final_key.resize(key_base.size());
+	final_key += key;
+	rmkey(prefix, final_key);
+      }
+      return num;
+    }
+
     /// Removes Keys
     void rmkeys(
       const std::string &prefix,        ///< [in] Prefix/CF to search for
@@ -225,6 +280,31 @@ public:
 	ceph_abort();
       }
     }
+    /// key/value of the current entry without copying them out of the
+    /// store; the views are only valid until the iterator is moved
+    virtual std::string_view key_as_sv() = 0;
+    virtual std::string_view value_as_sv() = 0;
+
+    using next_n_visitor_t =
+      std::function<bool(std::string_view key, std::string_view value)>;
+    /// Visit up to @max entries starting at the current position.
+    ///
+    /// Each entry is passed to @f and then stepped over.  If @f returns
+    /// false the iterator is left on that entry and the walk stops.  The
+    /// views passed to @f are only valid for the duration of the call.
+    ///
+    /// @returns the number of entries stepped over
+    virtual size_t next_n(size_t max, const next_n_visitor_t& f) {
+      size_t n = 0;
+      while (n < max && valid()) {
+	if (!f(key_as_sv(), value_as_sv())) {
+	  break;
+	}
+	next();
+	++n;
+      }
+      return n;
+    }
   };
   typedef std::shared_ptr< IteratorImpl > Iterator;
 
@@ -252,6 +332,10 @@ public:
         return ceph::buffer::ptr();
       }
     }
+    /// key (without prefix) and value of the current entry; valid only
+    /// until the iterator is moved
+    virtual std::string_view key_as_sv() = 0;
+    virtual std::string_view value_as_sv() = 0;
     virtual int status() = 0;
     virtual size_t key_size() {
       return 0;
@@ -318,6 +402,12 @@ private:
     ceph::buffer::ptr value_as_ptr() override {
       return generic_iter->value_as_ptr();
     }
+    std::string_view key_as_sv() override {
+      return generic_iter->key_as_sv();
+    }
+    std::string_view value_as_sv() override {
+      return generic_iter->value_as_sv();
+    }
     int status() override {
       return generic_iter->status();
     }
@@ -325,6 +415,8 @@ private:
 public:
   typedef uint32_t IteratorOpts;
   static const uint32_t ITERATOR_NOCACHE = 1;
+  /// hint that the iterator will be used for a long sequential scan
+  static const uint32_t ITERATOR_SCAN = 2;
 
   struct IteratorBounds {
     std::optional<std::string> lower_bound;
@@ -64,6 +64,10 @@ static bufferlist to_bufferlist(rocksdb::Slice in) {
   return bl;
 }
 
+static std::string_view to_sv(rocksdb::Slice in) {
+  return std::string_view(in.data(), in.size());
+}
+
 static rocksdb::SliceParts prepare_sliceparts(const bufferlist &bl,
 					      vector<rocksdb::Slice> *slices)
 {
@@ -686,6 +690,31 @@ rocksdb::ColumnFamilyHandle *RocksDBStore::get_cf_handle(const std::string& pref
   }
 }
 
+/**
+ * Resolve the CF for a run of keys that all start with key_base, and set *key to
+ * the raw key the run is appended to (prefix-combined when there is no CF for
+ * prefix). Returns nullptr if the CF is sharded on characters past key_base, in
+ * which case it has to be looked up for every key.
+ */
+rocksdb::ColumnFamilyHandle *RocksDBStore::get_run_cf_handle(const std::string& prefix,
+							     const std::string& key_base,
+							     std::string *key) {
+  auto iter = cf_handles.find(prefix);
+  if (iter == cf_handles.end()) {
+    combine_strings(prefix, key_base.data(), key_base.size(), key);
+    return default_cf;
+  }
+  *key = key_base;
+  auto& shards = iter->second;
+  if (shards.handles.size() == 1) {
+    return shards.handles[0];
+  }
+  if (shards.hash_h <= key_base.size()) {
+    return get_key_cf(shards, key_base.data(), key_base.size());
+  }
+  return nullptr;
+}
+
 /**
  * Definition of sharding:
  * space-separated list of: column_def [ '=' options ]
@@ -1659,6 +1688,50 @@ void RocksDBStore::RocksDBTransactionImpl::set(
   }
 }
 
+uint32_t RocksDBStore::RocksDBTransactionImpl::set_run(
+  const string &prefix,
+  const string &key_base,
+  bufferlist::const_iterator& p)
+{
+  using ceph::decode;
+  string key;
+  auto cf = db->get_run_cf_handle(prefix, key_base, &key);
+  size_t base_len = key.size();
+  uint32_t num;
+  decode(num, p);
+  for (uint32_t i = 0; i < num; ++i) {
+    uint32_t len;
+    decode(len, p);
+    key.resize(base_len + len);
+    p.copy(len, key.data() + base_len);
+    bufferlist value;
+    decode(value, p);
+    put_bat(bat, cf ? cf : db->get_cf_handle(prefix, key), key, value);
+  }
+  return num;
+}
+
+uint32_t RocksDBStore::RocksDBTransactionImpl::rmkeys_run(
+  const string &prefix,
+  const string &key_base,
+  bufferlist::const_iterator& p)
+{
+  using ceph::decode;
+  string key;
+  auto cf = db->get_run_cf_handle(prefix, key_base, &key);
+  size_t base_len = key.size();
+  uint32_t num;
+  decode(num, p);
+  for (uint32_t i = 0; i < num; ++i) {
+    uint32_t len;
+    decode(len, p);
+    key.resize(base_len + len);
+    p.copy(len, key.data() + base_len);
+    bat.Delete(cf ? cf : db->get_cf_handle(prefix, key), rocksdb::Slice(key));
+  }
+  return num;
+}
+
 void RocksDBStore::RocksDBTransactionImpl::rmkey(const string &prefix,
 					         const string &k)
 {
@@ -2207,6 +2280,22 @@ bufferptr RocksDBStore::RocksDBWholeSpaceIteratorImpl::value_as_ptr()
   return bufferptr(val.data(), val.size());
 }
 
+std::string_view RocksDBStore::RocksDBWholeSpaceIteratorImpl::key_as_sv()
+{
+  rocksdb::Slice key = dbiter->key();
+  auto separator = static_cast<const char*>(memchr(key.data(), 0, key.size()));
+  if (separator == nullptr) {
+    return std::string_view();
+  }
+  return std::string_view(separator + 1,
+			  key.size() - (separator - key.data()) - 1);
+}
+
+std::string_view RocksDBStore::RocksDBWholeSpaceIteratorImpl::value_as_sv()
+{
+  return to_sv(dbiter->value());
+}
+
 int RocksDBStore::RocksDBWholeSpaceIteratorImpl::status()
 {
   return dbiter->status().ok() ? 0 : -1;
@@ -2230,12 +2319,13 @@ public:
   explicit CFIteratorImpl(const RocksDBStore* db,
                           const std::string& p,
                           rocksdb::ColumnFamilyHandle* cf,
+                          KeyValueDB::IteratorOpts opts,
                           KeyValueDB::IteratorBounds bounds_)
     : prefix(p), bounds(std::move(bounds_)),
       iterate_lower_bound(make_slice(bounds.lower_bound)),
       iterate_upper_bound(make_slice(bounds.upper_bound))
       {
-      auto options = rocksdb::ReadOptions();
+      auto options = db->make_iterator_options(opts);
       if (db->cct->_conf->osd_rocksdb_iterator_bounds_enabled) {
         if (bounds.lower_bound) {
           options.iterate_lower_bound = &iterate_lower_bound;
@@ -2298,6 +2388,24 @@ public:
     rocksdb::Slice val = dbiter->value();
     return bufferptr(val.data(), val.size());
   }
+  std::string_view key_as_sv() override {
+    return to_sv(dbiter->key());
+  }
+  std::string_view value_as_sv() override {
+    return to_sv(dbiter->value());
+  }
+  size_t next_n(size_t max, const next_n_visitor_t& f) override {
+    // same as the generic version, minus the virtual dispatch per entry
+    size_t n = 0;
+    while (n < max && dbiter->Valid()) {
+      if (!f(to_sv(dbiter->key()), to_sv(dbiter->value()))) {
+        break;
+      }
+      dbiter->Next();
+      ++n;
+    }
+    return n;
+  }
   int status() override {
     return dbiter->status().ok() ? 0 : -1;
   }
@@ -2635,6 +2743,24 @@ public:
     }
   }
 
+  std::string_view key_as_sv() override
+  {
+    if (smaller == on_main) {
+      return main->key_as_sv();
+    } else {
+      return current_shard->second->key_as_sv();
+    }
+  }
+
+  std::string_view value_as_sv() override
+  {
+    if (smaller == on_main) {
+      return main->value_as_sv();
+    } else {
+      return current_shard->second->value_as_sv();
+    }
+  }
+
   int status() override
   {
     //because we already had to inspect key, it must be ok
@@ -2785,13 +2911,14 @@ public:
   explicit ShardMergeIteratorImpl(const RocksDBStore* db,
 				  const std::string& prefix,
 				  const std::vector<rocksdb::ColumnFamilyHandle*>& shards,
+                  KeyValueDB::IteratorOpts opts,
                   KeyValueDB::IteratorBounds bounds_)
     : db(db), keyless(db->comparator), prefix(prefix), bounds(std::move(bounds_)),
       iterate_lower_bound(make_slice(bounds.lower_bound)),
       iterate_upper_bound(make_slice(bounds.upper_bound))
   {
     iters.reserve(shards.size());
-    auto options = rocksdb::ReadOptions();
+    auto options = db->make_iterator_options(opts);
     if (db->cct->_conf->osd_rocksdb_iterator_bounds_enabled) {
       if (bounds.lower_bound) {
         options.iterate_lower_bound = &iterate_lower_bound;
@@ -2967,6 +3094,12 @@ public:
     rocksdb::Slice val = iters[0]->value();
     return bufferptr(val.data(), val.size());
   }
+  std::string_view key_as_sv() override {
+    return to_sv(iters[0]->key());
+  }
+  std::string_view value_as_sv() override {
+    return to_sv(iters[0]->value());
+  }
   int status() override {
     return iters[0]->status().ok() ? 0 : -1;
   }
@@ -2987,12 +3120,14 @@ KeyValueDB::Iterator RocksDBStore::get_iterator(const std::string& prefix, Itera
               this,
               prefix,
               cf,
+              opts,
               std::move(bounds));
     } else {
       return std::make_shared<ShardMergeIteratorImpl>(
         this,
         prefix,
         cf_it->second.handles,
+        opts,
         std::move(bounds));
     }
   } else {
@@ -3005,6 +3140,20 @@ rocksdb::Iterator* RocksDBStore::new_shard_iterator(rocksdb::ColumnFamilyHandle*
   return db->NewIterator(rocksdb::ReadOptions(), cf);
 }
 
+rocksdb::ReadOptions RocksDBStore::make_iterator_options(IteratorOpts opts) const
+{
+  rocksdb::ReadOptions options;
+  if (opts & ITERATOR_NOCACHE) {
+    options.fill_cache = false;
+  }
+  if (opts & ITERATOR_SCAN) {
+    // a fixed window for explicit scans; otherwise rocksdb ramps its own
+    // readahead up as the iterator keeps reading sequentially
+    options.readahead_size = iterator_scan_readahead;
+  }
+  return options;
+}
+
 RocksDBStore::WholeSpaceIterator RocksDBStore::get_wholespace_iterator(IteratorOpts opts)
 {
   if (cf_handles.size() == 0) {
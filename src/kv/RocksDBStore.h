@@ -133,6 +133,9 @@ private:
   rocksdb::ColumnFamilyHandle *get_cf_handle(const std::string& prefix, const std::string& key);
   rocksdb::ColumnFamilyHandle *get_cf_handle(const std::string& prefix, const char* key, size_t keylen);
   rocksdb::ColumnFamilyHandle *get_cf_handle(const std::string& prefix, const IteratorBounds& bounds);
+  rocksdb::ColumnFamilyHandle *get_run_cf_handle(const std::string& prefix,
+						 const std::string& key_base,
+						 std::string *key);
 
   int submit_common(rocksdb::WriteOptions& woptions, KeyValueDB::Transaction t);
   int install_cf_mergeop(const std::string &cf_name, rocksdb::ColumnFamilyOptions *cf_opt);
@@ -200,6 +203,7 @@ public:
   bool compact_on_mount;
   bool disableWAL;
   const uint64_t delete_range_threshold;
+  const uint64_t iterator_scan_readahead;
   void compact() override;
 
   void compact_async() override {
@@ -245,7 +249,8 @@ public:
     compact_thread(this),
     compact_on_mount(false),
     disableWAL(false),
-    delete_range_threshold(cct->_conf.get_val<uint64_t>("rocksdb_delete_range_threshold"))
+    delete_range_threshold(cct->_conf.get_val<uint64_t>("rocksdb_delete_range_threshold")),
+    iterator_scan_readahead(cct->_conf.get_val<Option::size_t>("rocksdb_iterator_scan_readahead"))
   {}
 
   ~RocksDBStore() override;
@@ -303,6 +308,10 @@ public:
       const char *k,
       size_t keylen,
       const ceph::bufferlist &bl) override;
+    uint32_t set_run(
+      const std::string &prefix,
+      const std::string &key_base,
+      ceph::bufferlist::const_iterator& p) override;
     void rmkey(
       const std::string &prefix,
       const std::string &k) override;
@@ -310,6 +319,10 @@ public:
       const std::string &prefix,
       const char *k,
       size_t keylen) override;
+    uint32_t rmkeys_run(
+      const std::string &prefix,
+      const std::string &key_base,
+      ceph::bufferlist::const_iterator& p) override;
     void rm_single_key(
       const std::string &prefix,
       const std::string &k) override;
@@ -358,9 +371,7 @@ public:
                                            rocksdb::ColumnFamilyHandle* cf,
                                            const KeyValueDB::IteratorOpts opts)
       {
-        rocksdb::ReadOptions options = rocksdb::ReadOptions();
-        if (opts & ITERATOR_NOCACHE)
-          options.fill_cache=false;
+        rocksdb::ReadOptions options = db->make_iterator_options(opts);
         dbiter = db->db->NewIterator(options, cf);
     }
     ~RocksDBWholeSpaceIteratorImpl() override;
@@ -379,6 +390,8 @@ public:
     bool raw_key_is_prefixed(const std::string &prefix) override;
     ceph::bufferlist value() override;
     ceph::bufferptr value_as_ptr() override;
+    std::string_view key_as_sv() override;
+    std::string_view value_as_sv() override;
     int status() override;
     size_t key_size() override;
     size_t value_size() override;
@@ -388,6 +401,8 @@ public:
 private:
   /// this iterator spans single cf
   rocksdb::Iterator* new_shard_iterator(rocksdb::ColumnFamilyHandle* cf);
+  /// translate KeyValueDB iterator options to rocksdb read options
+  rocksdb::ReadOptions make_iterator_options(IteratorOpts opts) const;
 public:
   /// Utility
   static std::string combine_strings(const std::string &prefix, const std::string &value) {
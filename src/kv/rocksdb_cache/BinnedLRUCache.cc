@@ -314,6 +314,9 @@ rocksdb::Cache::Handle* BinnedLRUCacheShard::Lookup(const rocksdb::Slice& key, u
     }
     e->refs++;
     e->SetHit();
+    hits_.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    misses_.fetch_add(1, std::memory_order_relaxed);
   }
   return reinterpret_cast<rocksdb::Cache::Handle*>(e);
 }
@@ -682,6 +685,16 @@ uint64_t BinnedLRUCache::sum_bins(uint32_t start, uint32_t end) const {
   return bytes;
 }
 
+bool BinnedLRUCache::get_hit_stats(uint64_t *hits, uint64_t *misses) const {
+  *hits = 0;
+  *misses = 0;
+  for (int s = 0; s < num_shards_; s++) {
+    *hits += shards_[s].get_hits();
+    *misses += shards_[s].get_misses();
+  }
+  return true;
+}
+
 uint32_t BinnedLRUCache::get_bin_count() const {
   uint32_t result = 0;
   if (num_shards_ > 0) {
@@ -10,6 +10,7 @@
 #ifndef ROCKSDB_BINNED_LRU_CACHE
 #define ROCKSDB_BINNED_LRU_CACHE
 
+#include <atomic>
 #include <string>
 #include <mutex>
 #include <boost/circular_buffer.hpp>
@@ -244,6 +245,14 @@ class alignas(CACHE_LINE_SIZE) BinnedLRUCacheShard : public CacheShard {
   // Get the byte counts for a range of age bins
   uint64_t sum_bins(uint32_t start, uint32_t end) const;
 
+  // Get the lookup hit/miss counts
+  uint64_t get_hits() const {
+    return hits_.load(std::memory_order_relaxed);
+  }
+  uint64_t get_misses() const {
+    return misses_.load(std::memory_order_relaxed);
+  }
+
  private:
   CephContext *cct;
   void LRU_Remove(BinnedLRUHandle* e);
@@ -306,6 +315,10 @@ class alignas(CACHE_LINE_SIZE) BinnedLRUCacheShard : public CacheShard {
   // Memory size for entries residing only in the LRU list
   size_t lru_usage_;
 
+  // Lookup outcomes, read without taking mutex_
+  std::atomic<uint64_t> hits_ = {0};
+  std::atomic<uint64_t> misses_ = {0};
+
   // mutex_ protects the following state.
   // We don't count mutex_ as the cache's internal state so semantically we
   // don't mind mutex_ invoking the non-const actions.
@@ -350,6 +363,7 @@ class BinnedLRUCache : public ShardedCache {
   uint64_t sum_bins(uint32_t start, uint32_t end) const;
   uint32_t get_bin_count() const;
   void set_bin_count(uint32_t count);
+  virtual bool get_hit_stats(uint64_t *hits, uint64_t *misses) const;
 
   virtual std::string get_cache_name() const {
     return "RocksDB Binned LRU Cache";
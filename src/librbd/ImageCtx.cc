@@ -284,6 +284,8 @@ librados::IoCtx duplicate_io_ctx(librados::IoCtx& io_ctx) {
     plb.add_u64_counter(l_librbd_resize, "resize", "Resizes");
     plb.add_u64_counter(l_librbd_readahead, "readahead", "Read ahead");
     plb.add_u64_counter(l_librbd_readahead_bytes, "readahead_bytes", "Data size in read ahead", NULL, 0, unit_t(UNIT_BYTES));
+    plb.add_u64_counter(l_librbd_readahead_useful_bytes, "readahead_useful_bytes", "Read ahead data subsequently read", NULL, 0, unit_t(UNIT_BYTES));
+    plb.add_u64_counter(l_librbd_readahead_wasted_bytes, "readahead_wasted_bytes", "Read ahead data abandoned unread", NULL, 0, unit_t(UNIT_BYTES));
     plb.add_u64_counter(l_librbd_invalidate_cache, "invalidate_cache", "Cache invalidates");
 
     plb.add_time(l_librbd_opened_time, "opened_time", "Opened time",
@@ -289,11 +289,36 @@ int DiffIterate<I>::execute() {
   uint64_t off = m_offset;
   uint64_t left = m_length;
 
+  // a period maps to the stripe_count objects of its object set: if none of
+  // them has anything to report, skip it without mapping it to extents
+  uint64_t object_set_size = m_image_ctx.layout.object_size *
+                             m_image_ctx.layout.stripe_count;
+  auto is_clean_period = [&](uint64_t period_off) {
+    uint64_t object_no = (period_off / object_set_size) *
+                         m_image_ctx.layout.stripe_count;
+    uint64_t end_object_no = object_no + m_image_ctx.layout.stripe_count;
+    if (end_object_no > object_diff_state.size()) {
+      return false;
+    }
+    for (; object_no < end_object_no; ++object_no) {
+      uint8_t diff_state = object_diff_state[object_no];
+      if (diff_state == object_map::DIFF_STATE_DATA ||
+          (diff_state == object_map::DIFF_STATE_HOLE &&
+           (from_snap_id != 0 || parent_diff.empty()))) {
+        continue;
+      }
+      return false;
+    }
+    return true;
+  };
+
   while (left > 0) {
     uint64_t period_off = off - (off % period);
     uint64_t read_len = std::min(period_off + period - off, left);
 
-    if (fast_diff_enabled) {
+    if (fast_diff_enabled && is_clean_period(period_off)) {
+      ldout(cct, 20) << "no diff in period " << period_off << dendl;
+    } else if (fast_diff_enabled) {
       // map to extents
       std::map<object_t,std::vector<ObjectExtent> > object_extents;
       Striper::file_to_extents(cct, m_image_ctx.format_string,
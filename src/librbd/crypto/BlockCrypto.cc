@@ -46,9 +46,6 @@ int BlockCrypto<T>::crypt(ceph::bufferlist* data, uint64_t image_offset,
   unsigned char* iv = (unsigned char*)alloca(m_iv_size);
   memset(iv, 0, m_iv_size);
 
-  bufferlist src = *data;
-  data->clear();
-
   auto ctx = m_data_cryptor->get_context(mode);
   if (ctx == nullptr) {
     lderr(m_cct) << "unable to get crypt context" << dendl;
@@ -59,6 +56,34 @@ int BlockCrypto<T>::crypt(ceph::bufferlist* data, uint64_t image_offset,
       m_data_cryptor->return_context(ctx, mode); });
 
   auto sector_number = image_offset / 512;
+  if (mode == CipherMode::CIPHER_MODE_DEC && data->get_num_buffers() == 1 &&
+      data->buffers().front().raw_nref() == 1) {
+    // ciphertext read back from the OSDs is not shared and not needed once
+    // decrypted: transform it in place rather than into a new buffer
+    auto buf_ptr = reinterpret_cast<unsigned char*>(data->c_str());
+    for (uint64_t off = 0; off < data->length(); off += m_block_size) {
+      auto block_offset_le = ceph_le64(sector_number);
+      memcpy(iv, &block_offset_le, sizeof(block_offset_le));
+      auto r = m_data_cryptor->init_context(ctx, iv, m_iv_size);
+      if (r != 0) {
+        lderr(m_cct) << "unable to init cipher's IV" << dendl;
+        return r;
+      }
+
+      r = m_data_cryptor->update_context(ctx, buf_ptr + off, buf_ptr + off,
+                                         m_block_size);
+      if (r < 0) {
+        lderr(m_cct) << "crypt update failed" << dendl;
+        return r;
+      }
+      sector_number += m_block_size / 512;
+    }
+    return 0;
+  }
+
+  bufferlist src = *data;
+  data->clear();
+
   auto appender = data->get_contiguous_appender(src.length());
   unsigned char* out_buf_ptr = nullptr;
   unsigned char* leftover_block = (unsigned char*)alloca(m_block_size);
@@ -15,7 +15,8 @@ template <typename T>
 class CryptoContextPool : public DataCryptor<T>  {
 
 public:
-    CryptoContextPool(DataCryptor<T>* data_cryptor, uint32_t pool_size);
+    CryptoContextPool(DataCryptor<T>* data_cryptor, uint32_t pool_size,
+                      bool own_data_cryptor = false);
     ~CryptoContextPool();
 
     T* get_context(CipherMode mode) override;
@@ -47,6 +48,7 @@ public:
 
 private:
     DataCryptor<T>* m_data_cryptor;
+    bool m_own_data_cryptor;
     ContextQueue m_encrypt_contexts;
     ContextQueue m_decrypt_contexts;
 
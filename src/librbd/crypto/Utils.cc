@@ -7,6 +7,7 @@
 #include "common/errno.h"
 #include "librbd/ImageCtx.h"
 #include "librbd/crypto/BlockCrypto.h"
+#include "librbd/crypto/CryptoContextPool.h"
 #include "librbd/crypto/CryptoImageDispatch.h"
 #include "librbd/crypto/CryptoObjectDispatch.h"
 #include "librbd/crypto/openssl/DataCryptor.h"
@@ -21,6 +22,8 @@ namespace librbd {
 namespace crypto {
 namespace util {
 
+static const uint32_t CRYPTO_CONTEXT_POOL_SIZE = 32;
+
 template <typename I>
 void set_crypto(I *image_ctx, ceph::ref_t<CryptoInterface> crypto) {
   {
@@ -60,8 +63,12 @@ int build_crypto(
     return r;
   }
 
+  // reuse keyed cipher contexts across requests: setting one up allocates
+  // it and runs the AES key schedule
+  auto context_pool = new CryptoContextPool<EVP_CIPHER_CTX>(
+          data_cryptor, CRYPTO_CONTEXT_POOL_SIZE, true);
   *result_crypto = BlockCrypto<EVP_CIPHER_CTX>::create(
-          cct, data_cryptor, block_size, data_offset);
+          cct, context_pool, block_size, data_offset);
   return 0;
 }
 
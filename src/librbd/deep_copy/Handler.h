@@ -17,6 +17,12 @@ struct Handler {
 
   virtual int update_progress(uint64_t object_number,
                               uint64_t object_count) = 0;
+
+  // maximum number of in-flight object copies (0 to use the source
+  // image's rbd_concurrent_management_ops)
+  virtual uint64_t get_max_concurrent_ops() {
+    return 0;
+  }
 };
 
 struct NoOpHandler : public Handler {
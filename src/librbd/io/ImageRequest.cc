@@ -152,6 +152,16 @@ void readahead(I *ictx, const Extents& image_extents, IOContext io_context) {
   uint64_t readahead_offset = readahead_extent.first;
   uint64_t readahead_length = readahead_extent.second;
 
+  auto prefetch_stats = ictx->readahead.pop_prefetch_stats();
+  if (prefetch_stats.useful_bytes > 0) {
+    ictx->perfcounter->inc(l_librbd_readahead_useful_bytes,
+                           prefetch_stats.useful_bytes);
+  }
+  if (prefetch_stats.wasted_bytes > 0) {
+    ictx->perfcounter->inc(l_librbd_readahead_wasted_bytes,
+                           prefetch_stats.wasted_bytes);
+  }
+
   if (readahead_length > 0) {
     ldout(ictx->cct, 20) << "(readahead logical) " << readahead_offset << "~"
                          << readahead_length << dendl;
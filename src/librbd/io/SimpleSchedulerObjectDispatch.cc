@@ -54,7 +54,7 @@ public:
     auto count = rolling_count(m_acc);
 
     if (count > 0) {
-      return rolling_sum(m_acc);
+      return rolling_sum(m_acc) / count;
     }
     return 0;
   }
@@ -391,6 +391,15 @@ bool SimpleSchedulerObjectDispatch<I>::try_delay_write(
   }
 
   auto &object_requests = it->second;
+  std::optional<ceph::real_clock::time_point> dispatch_time;
+  if (!object_requests->is_scheduled_dispatch()) {
+    dispatch_time = get_dispatch_time(*object_requests);
+    if (!dispatch_time) {
+      ldout(cct, 20) << "in-flight request is overdue" << dendl;
+      return false;
+    }
+  }
+
   bool delayed = object_requests->try_delay_request(
       object_off, std::move(data), io_context, op_flags, object_dispatch_flags,
       on_dispatched);
@@ -399,13 +408,7 @@ bool SimpleSchedulerObjectDispatch<I>::try_delay_write(
 
   // schedule dispatch on the first request added
   if (delayed && !object_requests->is_scheduled_dispatch()) {
-    auto dispatch_time = ceph::real_clock::now();
-    if (m_latency_stats) {
-      dispatch_time += std::chrono::nanoseconds(m_latency_stats->avg() / 2);
-    } else {
-      dispatch_time += std::chrono::milliseconds(m_max_delay);
-    }
-    object_requests->set_scheduled_dispatch(dispatch_time);
+    object_requests->set_scheduled_dispatch(*dispatch_time);
     m_dispatch_queue.push_back(object_requests);
     if (m_dispatch_queue.front() == object_requests) {
       schedule_dispatch_delayed_requests();
@@ -415,6 +418,32 @@ bool SimpleSchedulerObjectDispatch<I>::try_delay_write(
   return delayed;
 }
 
+template <typename I>
+std::optional<ceph::real_clock::time_point>
+SimpleSchedulerObjectDispatch<I>::get_dispatch_time(
+    const ObjectRequests &object_requests) const {
+  auto now = ceph::real_clock::now();
+  if (!m_latency_stats) {
+    return now + std::chrono::milliseconds(m_max_delay);
+  }
+
+  auto avg_latency = std::chrono::nanoseconds(m_latency_stats->avg());
+  auto start_time = object_requests.get_in_flight_start_time();
+  if (start_time == utime_t()) {
+    return now + avg_latency / 2;
+  }
+
+  // delayed requests are dispatched when the in-flight request completes,
+  // which should happen around start_time + avg_latency.  The timer only
+  // bounds the wait if it runs late, and if it already does, waiting for
+  // it would just add to the tail latency.
+  auto dispatch_time = start_time.to_real_time() + avg_latency;
+  if (dispatch_time <= now) {
+    return std::nullopt;
+  }
+  return dispatch_time;
+}
+
 template <typename I>
 void SimpleSchedulerObjectDispatch<I>::dispatch_all_delayed_requests() {
   ceph_assert(ceph_mutex_is_locked(m_lock));
@@ -432,7 +461,7 @@ template <typename I>
 void SimpleSchedulerObjectDispatch<I>::register_in_flight_request(
     uint64_t object_no, const utime_t &start_time, Context **on_finish) {
   auto res = m_requests.insert(
-      {object_no, std::make_shared<ObjectRequests>(object_no)});
+      {object_no, std::make_shared<ObjectRequests>(object_no, start_time)});
   ceph_assert(res.second);
   auto it = res.first;
 
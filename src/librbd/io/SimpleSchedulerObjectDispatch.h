@@ -14,6 +14,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <optional>
 
 namespace librbd {
 
@@ -128,7 +129,8 @@ private:
   public:
     using clock_t = ceph::real_clock;
 
-    ObjectRequests(uint64_t object_no) : m_object_no(object_no) {
+    ObjectRequests(uint64_t object_no, const utime_t &in_flight_start_time)
+      : m_object_no(object_no), m_in_flight_start_time(in_flight_start_time) {
     }
 
     uint64_t get_object_no() const {
@@ -143,6 +145,10 @@ private:
       return m_dispatch_seq;
     }
 
+    const utime_t &get_in_flight_start_time() const {
+      return m_in_flight_start_time;
+    }
+
     clock_t::time_point get_dispatch_time() const {
       return m_dispatch_time;
     }
@@ -173,6 +179,7 @@ private:
 
   private:
     uint64_t m_object_no;
+    utime_t m_in_flight_start_time;
     uint64_t m_dispatch_seq = 0;
     clock_t::time_point m_dispatch_time;
     IOContext m_io_context;
@@ -209,6 +216,8 @@ private:
                        int op_flags, int object_dispatch_flags,
                        Context* on_dispatched);
   bool intersects(uint64_t object_no, uint64_t object_off, uint64_t len) const;
+  std::optional<ceph::real_clock::time_point> get_dispatch_time(
+      const ObjectRequests &object_requests) const;
 
   void dispatch_all_delayed_requests();
   void dispatch_delayed_requests(uint64_t object_no);
@@ -620,12 +620,45 @@ private:
     read_clusters();
   }
 
+  bool is_contiguous(const ClusterExtent& prev,
+                     const ClusterExtent& next) const {
+    auto cluster_size = qcow_format->m_cluster_size;
+    auto is_data = [](const ClusterExtent& cluster_extent) {
+      return (cluster_extent.cluster_offset != 0 &&
+              cluster_extent.cluster_offset != QCOW_OFLAG_ZERO &&
+              (cluster_extent.cluster_offset & QCOW_OFLAG_COMPRESSED) == 0);
+    };
+    return (is_data(prev) && is_data(next) &&
+            prev.intra_cluster_offset + prev.cluster_length == cluster_size &&
+            next.intra_cluster_offset == 0 &&
+            next.cluster_offset == prev.cluster_offset + cluster_size &&
+            next.image_offset == prev.image_offset + prev.cluster_length);
+  }
+
   void read_clusters() {
     auto cct = qcow_format->m_image_ctx->cct;
     ldout(cct, 20) << dendl;
 
-    aio_comp->set_request_count(cluster_extents.size());
-    for (auto& cluster_extent : cluster_extents) {
+    // clusters that are adjacent in both the image and the QCOW file are
+    // fetched with a single stream read instead of one read per cluster
+    std::vector<std::pair<size_t, size_t>> runs;
+    for (size_t idx = 0; idx < cluster_extents.size(); ++idx) {
+      if (!runs.empty() &&
+          is_contiguous(cluster_extents[idx - 1], cluster_extents[idx])) {
+        ++runs.back().second;
+      } else {
+        runs.emplace_back(idx, 1);
+      }
+    }
+
+    aio_comp->set_request_count(runs.size());
+    for (auto [idx, count] : runs) {
+      if (count > 1) {
+        read_coalesced_clusters(idx, count);
+        continue;
+      }
+
+      auto& cluster_extent = cluster_extents[idx];
       auto read_ctx = new io::ReadResult::C_ImageReadRequest(
         aio_comp, cluster_extent.buffer_offset,
         {{cluster_extent.image_offset, cluster_extent.cluster_length}});
@@ -656,6 +689,33 @@ private:
     delete this;
   }
 
+  void read_coalesced_clusters(size_t idx, size_t count) {
+    auto cct = qcow_format->m_image_ctx->cct;
+    auto& first_extent = cluster_extents[idx];
+    uint64_t stream_offset = first_extent.cluster_offset +
+                             first_extent.intra_cluster_offset;
+    uint64_t length = 0;
+    for (size_t i = idx; i < idx + count; ++i) {
+      length += cluster_extents[i].cluster_length;
+    }
+
+    ldout(cct, 20) << "image_offset=" << first_extent.image_offset << ", "
+                   << "stream_offset=" << stream_offset << ", "
+                   << "length=" << length << ", "
+                   << "clusters=" << count << dendl;
+
+    auto read_ctx = new io::ReadResult::C_ImageReadRequest(
+      aio_comp, first_extent.buffer_offset,
+      {{first_extent.image_offset, length}});
+    auto log_ctx = new LambdaContext(
+      [this, cct, image_offset=first_extent.image_offset,
+       image_length=length, ctx=read_ctx](int r) {
+        handle_read_cluster(cct, r, image_offset, image_length, ctx);
+      });
+    qcow_format->m_stream->read({{stream_offset, length}}, &read_ctx->bl,
+                                log_ctx);
+  }
+
   void handle_read_cluster(CephContext* cct, int r, uint64_t image_offset,
                            uint64_t image_length, Context* on_finish) const {
     // NOTE: treat as static function, expect object has been deleted
@@ -3770,7 +3770,7 @@ void BlueStore::Onode::rewrite_omap_key(const string& old, string *out)
   out->append(old.c_str() + out->length(), old.size() - out->length());
 }
 
-void BlueStore::Onode::decode_omap_key(const string& key, string *user_key)
+void BlueStore::Onode::decode_omap_key(std::string_view key, string *user_key)
 {
   size_t pos = sizeof(uint64_t) + 1;
   if (!onode.is_pgmeta_omap()) {
@@ -3780,7 +3780,7 @@ void BlueStore::Onode::decode_omap_key(const string& key, string *user_key)
       pos += sizeof(uint64_t);
     }
   }
-  *user_key = key.substr(pos);
+  user_key->assign(key.substr(pos));
 }
 
 // =======================================================
@@ -4268,6 +4268,10 @@ void *BlueStore::MempoolThread::entry()
       interval_stats_trim = true;
 
       if (pcm != nullptr) {
+        if (store->cache_autotune_ratios) {
+          pcm->tune_ratios(store->cache_autotune_ratio_step,
+                           store->cache_autotune_ratio_max_skew);
+        }
         pcm->balance();
       }
 
@@ -4864,6 +4868,12 @@ int BlueStore::_set_cache_sizes()
 {
   ceph_assert(bdev);
   cache_autotune = cct->_conf.get_val<bool>("bluestore_cache_autotune");
+  cache_autotune_ratios =
+      cct->_conf.get_val<bool>("bluestore_cache_autotune_ratios");
+  cache_autotune_ratio_step =
+      cct->_conf.get_val<double>("bluestore_cache_autotune_ratio_step");
+  cache_autotune_ratio_max_skew =
+      cct->_conf.get_val<double>("bluestore_cache_autotune_ratio_max_skew");
   cache_autotune_interval =
       cct->_conf.get_val<double>("bluestore_cache_autotune_interval");
   cache_age_bin_interval =
@@ -7948,7 +7958,8 @@ void BlueStore::_fsck_repair_shared_blobs(
           ghobject_t,
           uint64_t,
           const bluestore_blob_t&)> cb) {
-      auto it = db->get_iterator(PREFIX_OBJ, KeyValueDB::ITERATOR_NOCACHE);
+      auto it = db->get_iterator(PREFIX_OBJ,
+        KeyValueDB::ITERATOR_NOCACHE | KeyValueDB::ITERATOR_SCAN);
       if (it) {
         CollectionRef c;
         spg_t pgid;
@@ -8782,7 +8793,8 @@ void BlueStore::_fsck_check_objects(
 
   size_t processed_myself = 0;
 
-  auto it = db->get_iterator(PREFIX_OBJ, KeyValueDB::ITERATOR_NOCACHE);
+  auto it = db->get_iterator(PREFIX_OBJ,
+    KeyValueDB::ITERATOR_NOCACHE | KeyValueDB::ITERATOR_SCAN);
   mempool::bluestore_fsck::list<string> expecting_shards;
   if (it) {
     const size_t thread_count = cct->_conf->bluestore_fsck_quick_fix_threads;
@@ -9305,7 +9317,8 @@ int BlueStore::_fsck_on_open(BlueStore::FSCKDepth depth, bool repair)
 #endif
 
   dout(1) << __func__ << " checking shared_blobs (phase 1)" << dendl;
-  it = db->get_iterator(PREFIX_SHARED_BLOB, KeyValueDB::ITERATOR_NOCACHE);
+  it = db->get_iterator(PREFIX_SHARED_BLOB,
+    KeyValueDB::ITERATOR_NOCACHE | KeyValueDB::ITERATOR_SCAN);
   if (it) {
     for (it->lower_bound(string()); it->valid(); it->next()) {
       string key = it->key();
@@ -9393,7 +9406,8 @@ int BlueStore::_fsck_on_open(BlueStore::FSCKDepth depth, bool repair)
     _fsck_repair_shared_blobs(repairer, sb_ref_counts, sb_info);
   }
   dout(1) << __func__ << " checking shared_blobs (phase 2)" << dendl;
-  it = db->get_iterator(PREFIX_SHARED_BLOB, KeyValueDB::ITERATOR_NOCACHE);
+  it = db->get_iterator(PREFIX_SHARED_BLOB,
+    KeyValueDB::ITERATOR_NOCACHE | KeyValueDB::ITERATOR_SCAN);
   if (it) {
     // FIXME minor: perhaps simplify for shallow mode?
     // fill global if not overriden below
@@ -9474,7 +9488,8 @@ int BlueStore::_fsck_on_open(BlueStore::FSCKDepth depth, bool repair)
     dout(1) << __func__ << " sorting out misreferenced extents" << dendl;
     auto& misref_extents = repairer.get_misreferences();
     interval_set<uint64_t> to_release;
-    it = db->get_iterator(PREFIX_OBJ, KeyValueDB::ITERATOR_NOCACHE);
+    it = db->get_iterator(PREFIX_OBJ,
+      KeyValueDB::ITERATOR_NOCACHE | KeyValueDB::ITERATOR_SCAN);
     if (it) {
       // fill global if not overriden below
       auto expected_statfs = &expected_store_statfs;
@@ -9691,7 +9706,8 @@ int BlueStore::_fsck_on_open(BlueStore::FSCKDepth depth, bool repair)
 
   if (depth != FSCK_SHALLOW) {
     dout(1) << __func__ << " checking for stray omap data " << dendl;
-    it = db->get_iterator(PREFIX_OMAP, KeyValueDB::ITERATOR_NOCACHE);
+    it = db->get_iterator(PREFIX_OMAP,
+      KeyValueDB::ITERATOR_NOCACHE | KeyValueDB::ITERATOR_SCAN);
     if (it) {
       uint64_t last_omap_head = 0;
       for (it->lower_bound(string()); it->valid(); it->next()) {
@@ -9713,7 +9729,8 @@ int BlueStore::_fsck_on_open(BlueStore::FSCKDepth depth, bool repair)
         }
       }
     }
-    it = db->get_iterator(PREFIX_PGMETA_OMAP, KeyValueDB::ITERATOR_NOCACHE);
+    it = db->get_iterator(PREFIX_PGMETA_OMAP,
+      KeyValueDB::ITERATOR_NOCACHE | KeyValueDB::ITERATOR_SCAN);
     if (it) {
       uint64_t last_omap_head = 0;
       for (it->lower_bound(string()); it->valid(); it->next()) {
@@ -9733,7 +9750,8 @@ int BlueStore::_fsck_on_open(BlueStore::FSCKDepth depth, bool repair)
         }
       }
     }
-    it = db->get_iterator(PREFIX_PERPOOL_OMAP, KeyValueDB::ITERATOR_NOCACHE);
+    it = db->get_iterator(PREFIX_PERPOOL_OMAP,
+      KeyValueDB::ITERATOR_NOCACHE | KeyValueDB::ITERATOR_SCAN);
     if (it) {
       uint64_t last_omap_head = 0;
       for (it->lower_bound(string()); it->valid(); it->next()) {
@@ -9757,7 +9775,8 @@ int BlueStore::_fsck_on_open(BlueStore::FSCKDepth depth, bool repair)
         }
       }
     }
-    it = db->get_iterator(PREFIX_PERPG_OMAP, KeyValueDB::ITERATOR_NOCACHE);
+    it = db->get_iterator(PREFIX_PERPG_OMAP,
+      KeyValueDB::ITERATOR_NOCACHE | KeyValueDB::ITERATOR_SCAN);
     if (it) {
       uint64_t last_omap_head = 0;
       for (it->lower_bound(string()); it->valid(); it->next()) {
@@ -11893,16 +11912,17 @@ int BlueStore::_onode_omap_get(
     KeyValueDB::Iterator it = db->get_iterator(prefix, 0, KeyValueDB::IteratorBounds{head, tail});
     it->lower_bound(head);
     while (it->valid()) {
-      if (it->key() == head) {
+      std::string_view key = it->key_as_sv();
+      if (key == head) {
         dout(30) << __func__ << "  got header" << dendl;
         *header = it->value();
-      } else if (it->key() >= tail) {
+      } else if (key >= tail) {
         dout(30) << __func__ << "  reached tail" << dendl;
         break;
       } else {
         string user_key;
-        o->decode_omap_key(it->key(), &user_key);
-        dout(20) << __func__ << "  got " << pretty_binary_string(it->key())
+        o->decode_omap_key(key, &user_key);
+        dout(20) << __func__ << "  got " << pretty_binary_string(key)
           << " -> " << user_key << dendl;
         (*out)[user_key] = it->value();
       }
@@ -11978,15 +11998,16 @@ int BlueStore::omap_get_keys(
     KeyValueDB::Iterator it = db->get_iterator(prefix, 0, KeyValueDB::IteratorBounds{head, tail});
     it->lower_bound(head);
     while (it->valid()) {
-      if (it->key() >= tail) {
+      std::string_view key = it->key_as_sv();
+      if (key >= tail) {
 	dout(30) << __func__ << "  reached tail" << dendl;
 	break;
       }
       string user_key;
-      o->decode_omap_key(it->key(), &user_key);
-      dout(20) << __func__ << "  got " << pretty_binary_string(it->key())
+      o->decode_omap_key(key, &user_key);
+      dout(20) << __func__ << "  got " << pretty_binary_string(key)
 	       << " -> " << user_key << dendl;
-      keys->insert(user_key);
+      keys->insert(std::move(user_key));
       it->next();
     }
   }
@@ -16576,21 +16597,11 @@ int BlueStore::_omap_setkeys(TransContext *txc,
     txc->note_modified_object(o);
   }
   const string& prefix = o->get_omap_prefix();
-  string final_key;
-  o->get_omap_key(string(), &final_key);
-  size_t base_key_len = final_key.size();
-  decode(num, p);
-  while (num--) {
-    string key;
-    bufferlist value;
-    decode(key, p);
-    decode(value, p);
-    final_key.resize(base_key_len); // keep prefix
-    final_key += key;
-    dout(20) << __func__ << "  " << pretty_binary_string(final_key)
-	     << " <- " << key << dendl;
-    txc->t->set(prefix, final_key, value);
-  }
+  string base_key;
+  o->get_omap_key(string(), &base_key);
+  num = txc->t->set_run(prefix, base_key, p);
+  dout(20) << __func__ << "  " << num << " keys under "
+	   << pretty_binary_string(base_key) << dendl;
   r = 0;
   dout(10) << __func__ << " " << c->cid << " " << o->oid << " = " << r << dendl;
   return r;
@@ -16644,18 +16655,10 @@ int BlueStore::_omap_rmkeys(TransContext *txc,
   {
     const string& prefix = o->get_omap_prefix();
     o->get_omap_key(string(), &final_key);
-    size_t base_key_len = final_key.size();
-    decode(num, p);
+    num = txc->t->rmkeys_run(prefix, final_key, p);
     logger->inc(l_bluestore_omap_rmkeys_count, num);
-    while (num--) {
-      string key;
-      decode(key, p);
-      final_key.resize(base_key_len); // keep prefix
-      final_key += key;
-      dout(20) << __func__ << "  rm " << pretty_binary_string(final_key)
-	       << " <- " << key << dendl;
-      txc->t->rmkey(prefix, final_key);
-    }
+    dout(20) << __func__ << "  rm " << num << " keys under "
+	     << pretty_binary_string(final_key) << dendl;
   }
   txc->note_modified_object(o);
 
@@ -18865,7 +18868,8 @@ void BlueStore::read_allocation_from_single_onode(
 int BlueStore::read_allocation_from_onodes(SimpleBitmap *sbmap, read_alloc_stats_t& stats)
 {
   // finally add all space take by user data
-  auto it = db->get_iterator(PREFIX_OBJ, KeyValueDB::ITERATOR_NOCACHE);
+  auto it = db->get_iterator(PREFIX_OBJ,
+    KeyValueDB::ITERATOR_NOCACHE | KeyValueDB::ITERATOR_SCAN);
   if (!it) {
     // TBD - find a better error code
     derr << "failed db->get_iterator(PREFIX_OBJ)" << dendl;
@@ -1242,7 +1242,7 @@ public:
     }
 
     void rewrite_omap_key(const std::string& old, std::string *out);
-    void decode_omap_key(const std::string& key, std::string *user_key);
+    void decode_omap_key(std::string_view key, std::string *user_key);
 
 #ifdef HAVE_LIBZBD
     // Return the offset of an object on disk.  This function is intended *only*
@@ -2280,6 +2280,9 @@ private:
   double cache_kv_onode_ratio = 0; ///< cache ratio dedicated to kv onodes (e.g., rocksdb onode CF)
   double cache_data_ratio = 0;   ///< cache ratio dedicated to object data
   bool cache_autotune = false;   ///< cache autotune setting
+  bool cache_autotune_ratios = false; ///< tune cache ratios from hit/miss feedback
+  double cache_autotune_ratio_step = 0; ///< fraction of a ratio moved per rebalance
+  double cache_autotune_ratio_max_skew = 0; ///< max factor between tuned and configured ratio
   double cache_age_bin_interval = 0; ///< time to wait between cache age bin rotations
   double cache_autotune_interval = 0; ///< time to wait between cache rebalancing
   std::vector<uint64_t> kv_bins; ///< kv autotune bins
@@ -2463,6 +2466,14 @@ private:
       virtual std::string get_cache_name() const {
         return "BlueStore Meta Cache";
       }
+      virtual bool get_hit_stats(uint64_t *hits, uint64_t *misses) const {
+        if (!store->logger) {
+          return false;
+        }
+        *hits = store->logger->get(l_bluestore_onode_hits);
+        *misses = store->logger->get(l_bluestore_onode_misses);
+        return true;
+      }
       uint64_t _get_num_onodes() const {
         uint64_t onode_num =
             mempool::bluestore_cache_onode::allocated_items();
@@ -2507,6 +2518,18 @@ private:
       virtual std::string get_cache_name() const {
         return "BlueStore Data Cache";
       }
+      virtual bool get_hit_stats(uint64_t *hits, uint64_t *misses) const {
+        if (!store->logger || !store->block_size) {
+          return false;
+        }
+        // count in blocks so the rates are comparable with the per-block
+        // lookups of the kv caches
+        *hits = store->logger->get(l_bluestore_buffer_hit_bytes) /
+          store->block_size;
+        *misses = store->logger->get(l_bluestore_buffer_miss_bytes) /
+          store->block_size;
+        return true;
+      }
     };
     std::shared_ptr<DataCache> data_cache;
 
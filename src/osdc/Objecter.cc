@@ -5002,7 +5002,9 @@ Objecter::OSDSession::~OSDSession()
 Objecter::Objecter(CephContext *cct,
 		   Messenger *m, MonClient *mc,
 		   boost::asio::io_context& service) :
-  Dispatcher(cct), messenger(m), monc(mc), service(service)
+  Dispatcher(cct), messenger(m), monc(mc), service(service),
+  pg_mapping_cache(cct->_conf.get_val<uint64_t>(
+		     "objecter_pg_mapping_cache_shards"))
 {
   mon_timeout = cct->_conf.get_val<std::chrono::seconds>("rados_mon_op_timeout");
   osd_timeout = cct->_conf.get_val<std::chrono::seconds>("rados_osd_op_timeout");
@@ -57,6 +57,7 @@
 #include "msg/Dispatcher.h"
 
 #include "osd/OSDMap.h"
+#include "osdc/PGMappingCache.h"
 
 class Context;
 class Messenger;
@@ -1663,68 +1664,22 @@ private:
   // to be drained by consume_blocklist_events.
   bool blocklist_events_enabled = false;
   std::set<entity_addr_t> blocklist_events;
-  struct pg_mapping_t {
-    epoch_t epoch = 0;
-    std::vector<int> up;
-    int up_primary = -1;
-    std::vector<int> acting;
-    int acting_primary = -1;
-
-    pg_mapping_t() {}
-    pg_mapping_t(epoch_t epoch, const std::vector<int>& up, int up_primary,
-                 const std::vector<int>& acting, int acting_primary)
-               : epoch(epoch), up(up), up_primary(up_primary),
-                 acting(acting), acting_primary(acting_primary) {}
-  };
-  ceph::shared_mutex pg_mapping_lock =
-    ceph::make_shared_mutex("Objecter::pg_mapping_lock");
-  // pool -> pg mapping
-  std::map<int64_t, std::vector<pg_mapping_t>> pg_mappings;
+  using pg_mapping_t = PGMappingCache::pg_mapping_t;
+  // pool -> pg mapping, striped by placement seed
+  PGMappingCache pg_mapping_cache;
 
   // convenient accessors
   bool lookup_pg_mapping(const pg_t& pg, epoch_t epoch, std::vector<int> *up,
                          int *up_primary, std::vector<int> *acting,
                          int *acting_primary) {
-    std::shared_lock l{pg_mapping_lock};
-    auto it = pg_mappings.find(pg.pool());
-    if (it == pg_mappings.end())
-      return false;
-    auto& mapping_array = it->second;
-    if (pg.ps() >= mapping_array.size())
-      return false;
-    if (mapping_array[pg.ps()].epoch != epoch) // stale
-      return false;
-    auto& pg_mapping = mapping_array[pg.ps()];
-    *up = pg_mapping.up;
-    *up_primary = pg_mapping.up_primary;
-    *acting = pg_mapping.acting;
-    *acting_primary = pg_mapping.acting_primary;
-    return true;
+    return pg_mapping_cache.lookup(pg, epoch, up, up_primary,
+                                   acting, acting_primary);
   }
   void update_pg_mapping(const pg_t& pg, pg_mapping_t&& pg_mapping) {
-    std::lock_guard l{pg_mapping_lock};
-    auto& mapping_array = pg_mappings[pg.pool()];
-    ceph_assert(pg.ps() < mapping_array.size());
-    mapping_array[pg.ps()] = std::move(pg_mapping);
+    pg_mapping_cache.update(pg, std::move(pg_mapping));
   }
   void prune_pg_mapping(const mempool::osdmap::map<int64_t,pg_pool_t>& pools) {
-    std::lock_guard l{pg_mapping_lock};
-    for (auto& pool : pools) {
-      auto& mapping_array = pg_mappings[pool.first];
-      size_t pg_num = pool.second.get_pg_num();
-      if (mapping_array.size() != pg_num) {
-        // catch both pg_num increasing & decreasing
-        mapping_array.resize(pg_num);
-      }
-    }
-    for (auto it = pg_mappings.begin(); it != pg_mappings.end(); ) {
-      if (!pools.count(it->first)) {
-        // pool is gone
-        pg_mappings.erase(it++);
-        continue;
-      }
-      it++;
-    }
+    pg_mapping_cache.prune(pools);
   }
 
 public:
@@ -0,0 +1,131 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+/*
+ * Ceph - scalable distributed file system
+ *
+ * This is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License version 2.1, as published by the Free Software
+ * Foundation.  See file COPYING.
+ *
+ */
+
+#ifndef CEPH_OSDC_PGMAPPINGCACHE_H
+#define CEPH_OSDC_PGMAPPINGCACHE_H
+
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+
+#include "common/ceph_mutex.h"
+#include "include/ceph_assert.h"
+#include "osd/osd_types.h"
+
+/**
+ * PGMappingCache
+ *
+ * Caches the CRUSH result (up/acting sets) of each pg for the epoch it was
+ * computed in, so that the Objecter does not have to run CRUSH for every op
+ * it submits.  The cache is striped by placement seed: every stripe has its
+ * own lock and holds the pgs whose ps() maps to it, so concurrent submitters
+ * targeting different pgs do not bounce a single lock between cores.
+ */
+class PGMappingCache {
+public:
+  struct pg_mapping_t {
+    epoch_t epoch = 0;
+    std::vector<int> up;
+    int up_primary = -1;
+    std::vector<int> acting;
+    int acting_primary = -1;
+
+    pg_mapping_t() {}
+    pg_mapping_t(epoch_t epoch, const std::vector<int>& up, int up_primary,
+                 const std::vector<int>& acting, int acting_primary)
+               : epoch(epoch), up(up), up_primary(up_primary),
+                 acting(acting), acting_primary(acting_primary) {}
+  };
+
+  explicit PGMappingCache(unsigned num_shards = 1)
+    : num_shards(num_shards ? num_shards : 1),
+      shards(new Shard[this->num_shards]) {}
+
+  unsigned get_num_shards() const {
+    return num_shards;
+  }
+
+  bool lookup(const pg_t& pg, epoch_t epoch, std::vector<int> *up,
+              int *up_primary, std::vector<int> *acting,
+              int *acting_primary) const {
+    auto& shard = shards[pg.ps() % num_shards];
+    std::shared_lock l{shard.lock};
+    auto it = shard.pg_mappings.find(pg.pool());
+    if (it == shard.pg_mappings.end())
+      return false;
+    auto& mapping_array = it->second;
+    auto idx = pg.ps() / num_shards;
+    if (idx >= mapping_array.size())
+      return false;
+    auto& pg_mapping = mapping_array[idx];
+    if (pg_mapping.epoch != epoch) // stale
+      return false;
+    *up = pg_mapping.up;
+    *up_primary = pg_mapping.up_primary;
+    *acting = pg_mapping.acting;
+    *acting_primary = pg_mapping.acting_primary;
+    return true;
+  }
+
+  void update(const pg_t& pg, pg_mapping_t&& pg_mapping) {
+    auto& shard = shards[pg.ps() % num_shards];
+    std::lock_guard l{shard.lock};
+    auto& mapping_array = shard.pg_mappings[pg.pool()];
+    auto idx = pg.ps() / num_shards;
+    ceph_assert(idx < mapping_array.size());
+    mapping_array[idx] = std::move(pg_mapping);
+  }
+
+  // resize per-pool arrays to the current pg_num and drop deleted pools
+  void prune(const mempool::osdmap::map<int64_t,pg_pool_t>& pools) {
+    for (unsigned i = 0; i < num_shards; ++i) {
+      auto& shard = shards[i];
+      std::lock_guard l{shard.lock};
+      for (auto& pool : pools) {
+        auto& mapping_array = shard.pg_mappings[pool.first];
+        size_t slots = shard_slots(pool.second.get_pg_num(), i);
+        if (mapping_array.size() != slots) {
+          // catch both pg_num increasing & decreasing
+          mapping_array.resize(slots);
+        }
+      }
+      for (auto it = shard.pg_mappings.begin();
+           it != shard.pg_mappings.end(); ) {
+        if (!pools.count(it->first)) {
+          // pool is gone
+          it = shard.pg_mappings.erase(it);
+          continue;
+        }
+        ++it;
+      }
+    }
+  }
+
+private:
+  struct Shard {
+    mutable ceph::shared_mutex lock =
+      ceph::make_shared_mutex("PGMappingCache::Shard::lock");
+    // pool -> pg mapping for the seeds owned by this shard
+    std::map<int64_t, std::vector<pg_mapping_t>> pg_mappings;
+  };
+
+  // number of seeds in [0, pg_num) with seed % num_shards == shard
+  size_t shard_slots(size_t pg_num, unsigned shard) const {
+    return pg_num / num_shards + (shard < pg_num % num_shards ? 1 : 0);
+  }
+
+  const unsigned num_shards;
+  std::unique_ptr<Shard[]> shards;
+};
+
+#endif
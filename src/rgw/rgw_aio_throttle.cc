@@ -29,6 +29,15 @@ bool Throttle::waiter_ready() const
   }
 }
 
+void Throttle::try_grow_window()
+{
+  if (window >= max_window || completed_size < window) {
+    return;
+  }
+  window = std::min(window * 2, max_window);
+  completed_size = 0;
+}
+
 AioResultList BlockingAioThrottle::get(const RGWSI_RADOS::Obj& obj,
                                        OpFunc&& f,
                                        uint64_t cost, uint64_t id)
@@ -45,6 +54,9 @@ AioResultList BlockingAioThrottle::get(const RGWSI_RADOS::Obj& obj,
   } else {
     // wait for the write size to become available
     pending_size += p->cost;
+    if (!is_available()) {
+      try_grow_window();
+    }
     if (!is_available()) {
       ceph_assert(waiter == Wait::None);
       waiter = Wait::Available;
@@ -73,6 +85,7 @@ void BlockingAioThrottle::put(AioResult& r)
   completed.push_back(p);
 
   pending_size -= p.cost;
+  completed_size += p.cost;
 
   if (waiter_ready()) {
     cond.notify_one();
@@ -135,6 +148,9 @@ AioResultList YieldingAioThrottle::get(const RGWSI_RADOS::Obj& obj,
   } else {
     // wait for the write size to become available
     pending_size += p->cost;
+    if (!is_available()) {
+      try_grow_window();
+    }
     if (!is_available()) {
       ceph_assert(waiter == Wait::None);
       ceph_assert(!completion);
@@ -161,6 +177,7 @@ void YieldingAioThrottle::put(AioResult& r)
   completed.push_back(p);
 
   pending_size -= p.cost;
+  completed_size += p.cost;
 
   if (waiter_ready()) {
     ceph_assert(completion);
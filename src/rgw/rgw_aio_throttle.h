@@ -16,6 +16,7 @@
 #pragma once
 
 #include "include/rados/librados_fwd.hpp"
+#include <algorithm>
 #include <memory>
 #include "common/ceph_mutex.h"
 #include "common/async/completion.h"
@@ -27,8 +28,11 @@ namespace rgw {
 
 class Throttle {
  protected:
-  const uint64_t window;
+  uint64_t window;
+  const uint64_t max_window;
   uint64_t pending_size = 0;
+  // bytes completed since the window last grew
+  uint64_t completed_size = 0;
 
   AioResultList pending;
   AioResultList completed;
@@ -42,8 +46,14 @@ class Throttle {
 
   bool waiter_ready() const;
 
+  // called when a request doesn't fit in the window. if a full window has
+  // completed since it last grew, the backend is keeping up with us: double
+  // the window (up to max_window) to keep more writes in flight
+  void try_grow_window();
+
  public:
-  Throttle(uint64_t window) : window(window) {}
+  Throttle(uint64_t window, uint64_t max_window = 0)
+    : window(window), max_window(std::max(window, max_window)) {}
 
   virtual ~Throttle() {
     // must drain before destructing
@@ -64,7 +74,8 @@ class BlockingAioThrottle final : public Aio, private Throttle {
     librados::AioCompletion *completion = nullptr;
   };
  public:
-  BlockingAioThrottle(uint64_t window) : Throttle(window) {}
+  BlockingAioThrottle(uint64_t window, uint64_t max_window = 0)
+    : Throttle(window, max_window) {}
 
   virtual ~BlockingAioThrottle() override {};
 
@@ -98,8 +109,8 @@ class YieldingAioThrottle final : public Aio, private Throttle {
 
  public:
   YieldingAioThrottle(uint64_t window, boost::asio::io_context& context,
-                      yield_context yield)
-    : Throttle(window), context(context), yield(yield)
+                      yield_context yield, uint64_t max_window = 0)
+    : Throttle(window, max_window), context(context), yield(yield)
   {}
 
   virtual ~YieldingAioThrottle() override {};
@@ -116,16 +127,19 @@ class YieldingAioThrottle final : public Aio, private Throttle {
   AioResultList drain() override final;
 };
 
-// return a smart pointer to Aio
-inline auto make_throttle(uint64_t window_size, optional_yield y)
+// return a smart pointer to Aio. the window starts at window_size and may
+// grow up to max_window_size while the backend keeps up
+inline auto make_throttle(uint64_t window_size, optional_yield y,
+                          uint64_t max_window_size = 0)
 {
   std::unique_ptr<Aio> aio;
   if (y) {
     aio = std::make_unique<YieldingAioThrottle>(window_size,
                                                 y.get_io_context(),
-                                                y.get_yield_context());
+                                                y.get_yield_context(),
+                                                max_window_size);
   } else {
-    aio = std::make_unique<BlockingAioThrottle>(window_size);
+    aio = std::make_unique<BlockingAioThrottle>(window_size, max_window_size);
   }
   return aio;
 }
@@ -22,9 +22,13 @@ namespace efs = std::experimental::filesystem;
 
 using namespace std;
 
+// cache files are written under a temporary name and renamed once complete,
+// so a crash never leaves a partial file under a chunk's name
+static const std::string d3n_tmp_suffix = ".d3n_tmp";
+
 int D3nCacheAioWriteRequest::d3n_prepare_libaio_write_op(bufferlist& bl, unsigned int len, string oid, string cache_location)
 {
-  std::string location = cache_location + oid;
+  std::string location = cache_location + oid + d3n_tmp_suffix;
   int r = 0;
 
   lsubdout(g_ceph_context, rgw_datacache, 20) << "D3nDataCache: " << __func__ << "(): Write To Cache, location=" << location << dendl;
@@ -71,6 +75,13 @@ void D3nDataCache::init(CephContext *_cct) {
   if(cache_location.back() != '/') {
       cache_location += "/";
   }
+  persistent = !g_conf()->rgw_d3n_l1_evict_cache_on_start;
+  admission_hits = cct->_conf.get_val<uint64_t>("rgw_d3n_l1_admission_hits");
+  if (admission_hits > 1) {
+    // a few counters per chunk that fits in the cache
+    d3n_miss_sketch.init(4 * free_data_cache_size /
+                         std::max<uint64_t>(cct->_conf->rgw_get_obj_max_req_size, 1));
+  }
   try {
     if (efs::exists(cache_location)) {
       // d3n: evict the cache storage directory
@@ -79,6 +90,8 @@ void D3nDataCache::init(CephContext *_cct) {
         for (auto& p : efs::directory_iterator(cache_location)) {
           efs::remove_all(p.path());
         }
+      } else {
+        d3n_load_cache();
       }
     } else {
       // create the cache storage directory
@@ -107,17 +120,69 @@ void D3nDataCache::init(CephContext *_cct) {
 #endif
 }
 
+void D3nDataCache::d3n_load_cache()
+{
+  struct cached_file {
+    efs::file_time_type mtime;
+    std::string oid;
+    uint64_t size;
+  };
+  std::vector<cached_file> files;
+
+  for (auto& p : efs::directory_iterator(cache_location)) {
+    const std::string oid = p.path().filename().string();
+    if (!p.is_regular_file()) {
+      continue;
+    }
+    if (oid.ends_with(d3n_tmp_suffix) || p.file_size() == 0) {
+      // interrupted cache write
+      efs::remove(p.path());
+      continue;
+    }
+    files.push_back({p.last_write_time(), oid, p.file_size()});
+  }
+  std::sort(files.begin(), files.end(),
+            [] (const cached_file& a, const cached_file& b) { return a.mtime < b.mtime; });
+
+  // drop the oldest files if the cache was shrunk since they were written
+  uint64_t total = 0;
+  for (const auto& f : files) {
+    total += f.size;
+  }
+  auto f = files.begin();
+  for (; f != files.end() && total > free_data_cache_size; ++f) {
+    efs::remove(cache_location + f->oid);
+    total -= f->size;
+  }
+
+  // most recently written ends up at the head of the lru
+  const std::lock_guard l(d3n_cache_lock);
+  const std::lock_guard le(d3n_eviction_lock);
+  for (; f != files.end(); ++f) {
+    auto* chunk_info = new D3nChunkDataInfo;
+    chunk_info->oid = f->oid;
+    chunk_info->set_ctx(cct);
+    chunk_info->size = f->size;
+    d3n_cache_map.insert(pair<string, D3nChunkDataInfo*>(f->oid, chunk_info));
+    lru_insert_head(chunk_info);
+  }
+  free_data_cache_size -= total;
+  lsubdout(g_ceph_context, rgw, 5) << "D3nDataCache: init: loaded " << d3n_cache_map.size()
+                                   << " cached chunks, " << total << " bytes" << dendl;
+}
+
 int D3nDataCache::d3n_io_write(bufferlist& bl, unsigned int len, std::string oid)
 {
   D3nChunkDataInfo* chunk_info = new D3nChunkDataInfo;
   std::string location = cache_location + oid;
+  std::string tmp_location = location + d3n_tmp_suffix;
 
   lsubdout(g_ceph_context, rgw_datacache, 20) << "D3nDataCache: " << __func__ << "(): location=" << location << dendl;
   FILE *cache_file = nullptr;
   int r = 0;
   size_t nbytes = 0;
 
-  cache_file = fopen(location.c_str(), "w+");
+  cache_file = fopen(tmp_location.c_str(), "w+");
   if (cache_file == nullptr) {
     ldout(cct, 0) << "ERROR: D3nDataCache::fopen file has return error, errno=" << errno << dendl;
     return -errno;
@@ -129,12 +194,29 @@ int D3nDataCache::d3n_io_write(bufferlist& bl, unsigned int len, std::string oid
     return -EIO;
   }
 
+  // as in the libaio path, a persistent cache must not index unsynced data
+  // after a crash
+  if (persistent &&
+      (fflush(cache_file) != 0 || ::fdatasync(fileno(cache_file)) < 0)) {
+    r = -errno;
+    ldout(cct, 0) << "ERROR: D3nDataCache::io_write: fdatasync has returned error, r=" << r << dendl;
+    fclose(cache_file);
+    ::remove(tmp_location.c_str());
+    return r;
+  }
+
   r = fclose(cache_file);
   if (r != 0) {
     ldout(cct, 0) << "ERROR: D3nDataCache::fclsoe file has return error, errno=" << errno << dendl;
     return -errno;
   }
 
+  r = ::rename(tmp_location.c_str(), location.c_str());
+  if (r != 0) {
+    ldout(cct, 0) << "ERROR: D3nDataCache::rename file has return error, errno=" << errno << dendl;
+    return -errno;
+  }
+
   { // update cahce_map entries for new chunk in cache
     const std::lock_guard l(d3n_cache_lock);
     chunk_info->oid = oid;
@@ -160,6 +242,33 @@ void D3nDataCache::d3n_libaio_write_completion_cb(D3nCacheAioWriteRequest* c)
 
   ldout(cct, 5) << "D3nDataCache: " << __func__ << "(): oid=" << c->oid << dendl;
 
+  const std::string location = cache_location + c->oid;
+  const std::string tmp_location = location + d3n_tmp_suffix;
+  int r = ::aio_error(c->cb);
+  if (r == 0 && ::aio_return(c->cb) != static_cast<ssize_t>(c->cb->aio_nbytes)) {
+    r = EIO;
+  }
+  if (r == 0 && persistent && ::fdatasync(c->fd) < 0) {
+    r = errno;
+  }
+  if (r == 0 && ::rename(tmp_location.c_str(), location.c_str()) < 0) {
+    r = errno;
+  }
+  if (r != 0) {
+    ldout(cct, 0) << "ERROR: D3nDataCache: " << __func__ << "(): cache write failed, oid=" << c->oid << ", r=" << r << dendl;
+    ::remove(tmp_location.c_str());
+    {
+      const std::lock_guard l(d3n_cache_lock);
+      d3n_outstanding_write_list.erase(c->oid);
+    }
+    {
+      const std::lock_guard l(d3n_eviction_lock);
+      outstanding_write_size -= c->cb->aio_nbytes;
+    }
+    delete c;
+    return;
+  }
+
   { // update cache_map entries for new chunk in cache
     const std::lock_guard l(d3n_cache_lock);
     d3n_outstanding_write_list.erase(c->oid);
@@ -226,6 +335,10 @@ void D3nDataCache::put(bufferlist& bl, unsigned int len, std::string& oid)
       ldout(cct, 10) << "D3nDataCache: NOTE: data put in cache already issued, no rewrite" << dendl;
       return;
     }
+    if (admission_hits > 1 && d3n_miss_sketch.increment(oid) < admission_hits) {
+      ldout(cct, 10) << "D3nDataCache: NOTE: chunk not requested often enough yet, not cached" << dendl;
+      return;
+    }
     d3n_outstanding_write_list.insert(oid);
   }
   {
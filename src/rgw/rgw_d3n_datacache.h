@@ -60,11 +60,80 @@ struct D3nCacheAioWriteRequest {
   }
 };
 
+/* D3nFrequencySketch
+ * compact count-min sketch of recent cache misses, used to only admit chunks
+ * that missed a few times. counters saturate at 15 and are halved after
+ * sample_size increments, so old popularity fades away */
+class D3nFrequencySketch {
+  static constexpr unsigned depth = 4;
+  static constexpr uint8_t max_count = 15;
+  // two 4-bit counters per byte
+  std::vector<uint8_t> table;
+  size_t width = 0;
+  size_t additions = 0;
+  size_t sample_size = 0;
+
+  size_t index(size_t hash, unsigned row) const {
+    // derive one hash per row from the key hash
+    uint64_t h = hash + row * 0x9e3779b97f4a7c15ull;
+    h = (h ^ (h >> 33)) * 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    return row * width + (h % width);
+  }
+
+  unsigned get(size_t i) const {
+    return (table[i / 2] >> ((i % 2) * 4)) & max_count;
+  }
+
+  void inc(size_t i) {
+    table[i / 2] += 1 << ((i % 2) * 4);
+  }
+
+  void reset() {
+    // halve both counters of each byte
+    for (auto& c : table) {
+      c = (c >> 1) & 0x77;
+    }
+    additions /= 2;
+  }
+
+public:
+  void init(size_t _width) {
+    width = std::max<size_t>(_width, 64);
+    table.assign((depth * width + 1) / 2, 0);
+    additions = 0;
+    sample_size = width * 10;
+  }
+
+  // count one more occurrence of the key and return its estimated frequency
+  unsigned increment(const std::string& key) {
+    const size_t hash = std::hash<std::string>{}(key);
+    unsigned estimate = max_count;
+    for (unsigned row = 0; row < depth; row++) {
+      const size_t i = index(hash, row);
+      unsigned c = get(i);
+      if (c < max_count) {
+        inc(i);
+        c++;
+      }
+      estimate = std::min(estimate, c);
+    }
+    if (++additions >= sample_size) {
+      reset();
+    }
+    return estimate;
+  }
+};
+
 struct D3nDataCache {
 
 private:
   std::unordered_map<std::string, D3nChunkDataInfo*> d3n_cache_map;
   std::set<std::string> d3n_outstanding_write_list;
+  D3nFrequencySketch d3n_miss_sketch;
+  uint64_t admission_hits = 1;
+  // keep the cache files on shutdown and index them again on start
+  bool persistent = false;
   std::mutex d3n_cache_lock;
   std::mutex d3n_eviction_lock;
 
@@ -86,11 +155,21 @@ private:
 
 private:
   void add_io();
+  void d3n_load_cache();
 
 public:
   D3nDataCache();
   ~D3nDataCache() {
-    while (lru_eviction() > 0);
+    if (persistent) {
+      // leave the files behind for the next start
+      for (auto& [oid, entry] : d3n_cache_map) {
+        delete entry;
+      }
+      d3n_cache_map.clear();
+      head = tail = nullptr;
+    } else {
+      while (lru_eviction() > 0);
+    }
   }
 
   std::string cache_location;
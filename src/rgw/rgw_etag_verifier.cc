@@ -83,7 +83,7 @@ int ETagVerifier_Atomic::process(bufferlist&& in, uint64_t logical_offset)
 {
   bufferlist out;
   if (in.length() > 0)
-    hash.Update((const unsigned char *)in.c_str(), in.length());
+    hash.Update(in);
 
   return Pipe::process(std::move(in), logical_offset);
 }
@@ -130,7 +130,7 @@ int ETagVerifier_MPU::process(bufferlist&& in, uint64_t logical_offset)
 
   /* Handle the last MPU part */
   if (size_t(next_part_index) == part_ofs.size()) {
-    hash.Update((const unsigned char *)in.c_str(), in.length());
+    hash.Update(in);
     goto done;
   }
 
@@ -138,11 +138,14 @@ int ETagVerifier_MPU::process(bufferlist&& in, uint64_t logical_offset)
   if (bl_end > part_ofs[next_part_index]) {
 
     uint64_t part_one_len = part_ofs[next_part_index] - logical_offset;
-    hash.Update((const unsigned char *)in.c_str(), part_one_len);
+    bufferlist part;
+    part.substr_of(in, 0, part_one_len);
+    hash.Update(part);
     process_end_of_MPU_part();
 
-    hash.Update((const unsigned char *)in.c_str() + part_one_len,
-      bl_end - part_ofs[cur_part_index]);
+    part.clear();
+    part.substr_of(in, part_one_len, bl_end - part_ofs[cur_part_index]);
+    hash.Update(part);
     /*
      * If we've moved to the last part of the MPU, avoid usage of
      * parts_ofs[next_part_index] as it will lead to our-of-range access.
@@ -150,7 +153,7 @@ int ETagVerifier_MPU::process(bufferlist&& in, uint64_t logical_offset)
     if (size_t(next_part_index) == part_ofs.size())
       goto done;
   } else {
-    hash.Update((const unsigned char *)in.c_str(), in.length());
+    hash.Update(in);
   }
 
   /* Update the MPU Etag if the current part has ended */
@@ -1854,7 +1854,8 @@ namespace rgw {
     /* skipping user-supplied etag--we might have one in future, but
      * like data it and other attrs would arrive after open */
 
-    aio.emplace(state->cct->_conf->rgw_put_obj_min_window_size);
+    aio.emplace(state->cct->_conf->rgw_put_obj_min_window_size,
+                state->cct->_conf->rgw_put_obj_max_window_size);
 
     if (state->bucket->versioning_enabled()) {
       if (!version_id.empty()) {
@@ -1913,7 +1914,7 @@ namespace rgw {
     if (! len)
       return 0;
 
-    hash.Update((const unsigned char *)data.c_str(), data.length());
+    hash.Update(data);
     op_ret = filter->process(std::move(data), ofs);
     if (op_ret < 0) {
       goto done;
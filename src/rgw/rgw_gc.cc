@@ -402,7 +402,17 @@ public:
 
   int handle_next_completion() {
     ceph_assert(!ios.empty());
-    IO& io = ios.front();
+    /* don't let a single slow osd hold up the whole window: take any io that
+     * already completed before waiting on the oldest one
+     */
+    auto it = std::find_if(ios.begin(), ios.end(),
+                           [](const IO& io) { return io.c->is_complete(); });
+    if (it == ios.end()) {
+      it = ios.begin();
+    }
+    IO io = std::move(*it);
+    ios.erase(it);
+
     io.c->wait_for_complete();
     int ret = io.c->get_return_value();
     io.c->release();
@@ -430,7 +440,6 @@ public:
     }
 
   done:
-    ios.pop_front();
     return ret;
   }
 
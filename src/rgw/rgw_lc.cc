@@ -220,7 +220,13 @@ void *RGWLC::LCWorker::entry() {
     utime_t start = ceph_clock_now();
     if (should_work(start)) {
       ldpp_dout(dpp, 2) << "life cycle: start" << dendl;
+      if (perfcounter) {
+        perfcounter->inc(l_rgw_lc_active_workers, 1);
+      }
       int r = lc->process(this, all_buckets, false /* once */);
+      if (perfcounter) {
+        perfcounter->dec(l_rgw_lc_active_workers, 1);
+      }
       if (r < 0) {
         ldpp_dout(dpp, 0) << "ERROR: do life cycle process() returned error r="
 			  << r << dendl;
@@ -687,6 +693,7 @@ public:
 private:
   const work_f bsf = [](RGWLC::LCWorker* wk, WorkQ* wq, WorkItem& wi) {};
   RGWLC::LCWorker* wk;
+  RGWLC::WorkPool* pool;
   uint32_t qmax;
   int ix;
   std::mutex mtx;
@@ -696,11 +703,16 @@ private:
   work_f f;
 
 public:
-  WorkQ(RGWLC::LCWorker* wk, uint32_t ix, uint32_t qmax)
-    : wk(wk), qmax(qmax), ix(ix), flags(FLAG_NONE), f(bsf)
-    {
-      create(thr_name().c_str());
-    }
+  WorkQ(RGWLC::LCWorker* wk, RGWLC::WorkPool* pool, uint32_t ix,
+	uint32_t qmax)
+    : wk(wk), pool(pool), qmax(qmax), ix(ix), flags(FLAG_NONE), f(bsf)
+    {}
+
+  /* the thread steals from its siblings, so the pool starts all of them
+   * once it is fully built */
+  void start() {
+    create(thr_name().c_str());
+  }
 
   std::string thr_name() {
     return std::string{"wp_thrd: "}
@@ -725,66 +737,75 @@ public:
     }
   }
 
-  void drain() {
+  /* enqueue only if there is room, without waiting */
+  bool try_enqueue(WorkItem& item) {
     unique_lock uniq(mtx);
-    flags |= FLAG_EDRAIN_SYNC;
-    while (flags & FLAG_EDRAIN_SYNC) {
-      cv.wait_for(uniq, 200ms);
+    if (items.size() > qmax) {
+      return false;
     }
+    items.push_back(item);
+    if (flags & FLAG_DWAIT_SYNC) {
+      flags &= ~FLAG_DWAIT_SYNC;
+      cv.notify_one();
+    }
+    return true;
   }
 
-private:
-  dequeue_result dequeue() {
+  /* called by an idle sibling: hand over the oldest queued item */
+  bool steal(WorkItem& item) {
     unique_lock uniq(mtx);
-    while ((!wk->get_lc()->going_down()) &&
-	   (items.size() == 0)) {
-      /* clear drain state, as we are NOT doing work and qlen==0 */
-      if (flags & FLAG_EDRAIN_SYNC) {
-	flags &= ~FLAG_EDRAIN_SYNC;
-      }
-      flags |= FLAG_DWAIT_SYNC;
-      cv.wait_for(uniq, 200ms);
+    if (items.size() < 2) {
+      /* leave the last one to our own thread */
+      return false;
     }
-    if (items.size() > 0) {
-      auto item = items.back();
-      items.pop_back();
-      if (flags & FLAG_EWAIT_SYNC) {
-	flags &= ~FLAG_EWAIT_SYNC;
-	cv.notify_one();
-      }
-      return {item};
+    item = std::move(items.front());
+    items.erase(items.begin());
+    if (flags & FLAG_EWAIT_SYNC) {
+      flags &= ~FLAG_EWAIT_SYNC;
+      cv.notify_one();
     }
-    return nullptr;
+    return true;
   }
 
-  void* entry() override {
-    while (!wk->get_lc()->going_down()) {
-      auto item = dequeue();
-      if (item.which() == 0) {
-	/* going down */
-	break;
-      }
-      f(wk, this, boost::get<WorkItem>(item));
+  void drain() {
+    unique_lock uniq(mtx);
+    flags |= FLAG_EDRAIN_SYNC;
+    while (flags & FLAG_EDRAIN_SYNC) {
+      cv.wait_for(uniq, 200ms);
     }
-    return nullptr;
   }
+
+private:
+  dequeue_result dequeue();
+  void* entry() override;
 }; /* WorkQ */
 
 class RGWLC::WorkPool
 {
   using TVector = ceph::containers::tiny_vector<WorkQ, 3>;
+  RGWLC::LCWorker* wk;
   TVector wqs;
   uint64_t ix;
 
+  /* items enqueued but not yet processed, whichever thread runs them */
+  std::mutex mtx;
+  std::condition_variable cv;
+  uint64_t inflight{0};
+
 public:
   WorkPool(RGWLC::LCWorker* wk, uint16_t n_threads, uint32_t qmax)
-    : wqs(TVector{
+    : wk(wk),
+      wqs(TVector{
 	n_threads,
 	[&](const size_t ix, auto emplacer) {
-	  emplacer.emplace(wk, ix, qmax);
+	  emplacer.emplace(wk, this, ix, qmax);
 	}}),
       ix(0)
-    {}
+    {
+      for (auto& wq : wqs) {
+	wq.start();
+      }
+    }
 
   ~WorkPool() {
     for (auto& wq : wqs) {
@@ -799,18 +820,104 @@ public:
   }
 
   void enqueue(WorkItem item) {
+    {
+      std::lock_guard l(mtx);
+      ++inflight;
+    }
     const auto tix = ix;
     ix = (ix+1) % wqs.size();
+    /* rather than block behind a busy thread, hand the item to any thread
+     * with room in its queue */
+    for (size_t i = 0; i < wqs.size(); ++i) {
+      if (wqs[(tix + i) % wqs.size()].try_enqueue(item)) {
+	return;
+      }
+    }
     (wqs[tix]).enqueue(std::move(item));
   }
 
+  /* let an idle thread take work queued on a busy one */
+  bool steal(WorkQ* thief, WorkItem& item) {
+    for (auto& wq : wqs) {
+      if (&wq != thief && wq.steal(item)) {
+	if (perfcounter) {
+	  perfcounter->inc(l_rgw_lc_work_stolen, 1);
+	}
+	return true;
+      }
+    }
+    return false;
+  }
+
+  void finish() {
+    if (perfcounter) {
+      perfcounter->inc(l_rgw_lc_processed, 1);
+    }
+    std::lock_guard l(mtx);
+    if (--inflight == 0) {
+      cv.notify_all();
+    }
+  }
+
   void drain() {
     for (auto& wq : wqs) {
       wq.drain();
     }
+    /* items stolen from a queue may still run on another thread */
+    std::unique_lock l(mtx);
+    while ((!wk->get_lc()->going_down()) && (inflight > 0)) {
+      cv.wait_for(l, 200ms);
+    }
   }
 }; /* WorkPool */
 
+WorkQ::dequeue_result WorkQ::dequeue()
+{
+  while (!wk->get_lc()->going_down()) {
+    {
+      unique_lock uniq(mtx);
+      if (items.size() > 0) {
+	auto item = items.back();
+	items.pop_back();
+	if (flags & FLAG_EWAIT_SYNC) {
+	  flags &= ~FLAG_EWAIT_SYNC;
+	  cv.notify_one();
+	}
+	return {item};
+      }
+    }
+    WorkItem item;
+    if (pool->steal(this, item)) {
+      return {item};
+    }
+    unique_lock uniq(mtx);
+    if ((!wk->get_lc()->going_down()) &&
+	(items.size() == 0)) {
+      /* clear drain state, as we are NOT doing work and qlen==0 */
+      if (flags & FLAG_EDRAIN_SYNC) {
+	flags &= ~FLAG_EDRAIN_SYNC;
+      }
+      flags |= FLAG_DWAIT_SYNC;
+      cv.wait_for(uniq, 200ms);
+    }
+  }
+  return nullptr;
+}
+
+void* WorkQ::entry()
+{
+  while (!wk->get_lc()->going_down()) {
+    auto item = dequeue();
+    if (item.which() == 0) {
+      /* going down */
+      break;
+    }
+    f(wk, this, boost::get<WorkItem>(item));
+    pool->finish();
+  }
+  return nullptr;
+}
+
 RGWLC::LCWorker::LCWorker(const DoutPrefixProvider* dpp, CephContext *cct,
 			  RGWLC *lc, int ix)
   : dpp(dpp), cct(cct), lc(lc), ix(ix)
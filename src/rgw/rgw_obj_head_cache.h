@@ -0,0 +1,106 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab ft=cpp
+
+/*
+ * Ceph - scalable distributed file system
+ *
+ * This is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License version 2.1, as published by the Free Software
+ * Foundation.  See file COPYING.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/ceph_mutex.h"
+#include "common/ceph_time.h"
+#include "common/lru_map.h"
+#include "rgw_common.h"
+
+struct obj_head_entry {
+  ceph::coarse_mono_time expires;
+  bool exists{false};
+  uint64_t size{0};
+  ceph::real_time mtime;
+  uint64_t epoch{0};
+  std::map<std::string, bufferlist> attrset;
+};
+
+/*
+ * RGWObjHeadCache
+ *
+ * Caches the result of reading an object head (stat and xattrs, or ENOENT)
+ * for rgw_obj_head_cache_ttl, so that repeated HEAD requests and misses on
+ * the same object do not each cost a RADOS read. Local modifications
+ * invalidate their entry through the bucket index update; changes made
+ * through other gateways are only seen once the entry expires.
+ */
+class RGWObjHeadCache {
+  struct Shard {
+    ceph::mutex lock = ceph::make_mutex("RGWObjHeadCache::Shard");
+    lru_map<rgw_obj, obj_head_entry> entries;
+    // bumped by every invalidation, so that a read that raced with a
+    // modification doesn't put the old head back in the cache
+    uint64_t gen{0};
+
+    explicit Shard(int max) : entries(max) {}
+  };
+  static constexpr size_t num_shards = 16;
+  std::vector<std::unique_ptr<Shard>> shards;
+  const ceph::timespan ttl;
+
+  Shard& get_shard(const rgw_obj& obj) {
+    return *shards[std::hash<std::string>{}(obj.key.name) % num_shards];
+  }
+
+public:
+  RGWObjHeadCache(size_t max_entries, ceph::timespan ttl) : ttl(ttl) {
+    const int per_shard = std::max<size_t>(max_entries / num_shards, 1);
+    for (size_t i = 0; i < num_shards; ++i) {
+      shards.push_back(std::make_unique<Shard>(per_shard));
+    }
+  }
+
+  static bool is_cacheable(const RGWBucketInfo& bucket_info, const rgw_obj& obj) {
+    // versioned buckets modify the olh outside of the object's index update
+    return !bucket_info.versioned() && obj.key.instance.empty() &&
+           obj.key.ns.empty();
+  }
+
+  bool find(const rgw_obj& obj, obj_head_entry& entry) {
+    if (!get_shard(obj).entries.find(obj, entry)) {
+      return false;
+    }
+    return entry.expires > ceph::coarse_mono_clock::now();
+  }
+
+  // sample before reading the head, and pass to add() afterwards
+  uint64_t get_gen(const rgw_obj& obj) {
+    auto& shard = get_shard(obj);
+    std::lock_guard l{shard.lock};
+    return shard.gen;
+  }
+
+  void add(const rgw_obj& obj, uint64_t gen, obj_head_entry& entry) {
+    auto& shard = get_shard(obj);
+    std::lock_guard l{shard.lock};
+    if (shard.gen != gen) {
+      return;
+    }
+    entry.expires = ceph::coarse_mono_clock::now() + ttl;
+    shard.entries.add(obj, entry);
+  }
+
+  void invalidate(const rgw_obj& obj) {
+    auto& shard = get_shard(obj);
+    std::lock_guard l{shard.lock};
+    ++shard.gen;
+    shard.entries.erase(obj);
+  }
+};
@@ -4085,7 +4085,7 @@ void RGWPutObj::execute(optional_yield y)
     }
 
     if (need_calc_md5) {
-      hash.Update((const unsigned char *)data.c_str(), data.length());
+      hash.Update(data);
     }
 
     /* update torrrent */
@@ -4418,7 +4418,7 @@ void RGWPostObj::execute(optional_yield y)
         break;
       }
 
-      hash.Update((const unsigned char *)data.c_str(), data.length());
+      hash.Update(data);
       op_ret = filter->process(std::move(data), ofs);
       if (op_ret < 0) {
         return;
@@ -7471,7 +7471,7 @@ int RGWBulkUploadOp::handle_file(const std::string_view path,
       op_ret = len;
       return op_ret;
     } else if (len > 0) {
-      hash.Update((const unsigned char *)data.c_str(), data.length());
+      hash.Update(data);
       op_ret = filter->process(std::move(data), ofs);
       if (op_ret < 0) {
         ldpp_dout(this, 20) << "filter->process() returned ret=" << op_ret << dendl;
@@ -7918,6 +7918,9 @@ int RGWHandler::do_read_permissions(RGWOp *op, bool only_bucket, optional_yield
     /* already read bucket info */
     return 0;
   }
+  if (op->use_head_cache() && !rgw::sal::Object::empty(s->object.get())) {
+    s->object->set_use_head_cache();
+  }
   int ret = rgw_build_object_policies(op, store, s, op->prefetch_data(), y);
 
   if (ret < 0) {
@@ -241,6 +241,9 @@ public:
 
   virtual int verify_params() { return 0; }
   virtual bool prefetch_data() { return false; }
+  /* only ops that just read the object may see a head cached by an earlier
+   * request */
+  virtual bool use_head_cache() { return false; }
 
   /* Authenticate requester -- verify its identity.
    *
@@ -400,6 +403,7 @@ public:
  }
 
   bool prefetch_data() override;
+  bool use_head_cache() override { return true; }
 
   void set_get_data(bool get_data) {
     this->get_data = get_data;
@@ -31,6 +31,9 @@ int rgw_perf_start(CephContext *cct)
   plb.add_u64_counter(l_rgw_cache_hit, "cache_hit", "Cache hits");
   plb.add_u64_counter(l_rgw_cache_miss, "cache_miss", "Cache miss");
 
+  plb.add_u64_counter(l_rgw_obj_head_cache_hit, "obj_head_cache_hit", "Object head cache hits");
+  plb.add_u64_counter(l_rgw_obj_head_cache_miss, "obj_head_cache_miss", "Object head cache miss");
+
   plb.add_u64_counter(l_rgw_keystone_token_cache_hit, "keystone_token_cache_hit", "Keystone token cache hits");
   plb.add_u64_counter(l_rgw_keystone_token_cache_miss, "keystone_token_cache_miss", "Keystone token cache miss");
 
@@ -49,6 +52,12 @@ int rgw_perf_start(CephContext *cct)
 		      "Lifecycle non-current transition");
   plb.add_u64_counter(l_rgw_lc_abort_mpu, "lc_abort_mpu",
 		      "Lifecycle abort multipart upload");
+  plb.add_u64_counter(l_rgw_lc_processed, "lc_processed",
+		      "Lifecycle objects and uploads evaluated");
+  plb.add_u64_counter(l_rgw_lc_work_stolen, "lc_work_stolen",
+		      "Lifecycle work items taken over by an idle worker thread");
+  plb.add_u64(l_rgw_lc_active_workers, "lc_active_workers",
+	      "Lifecycle workers currently processing");
 
   plb.add_u64_counter(l_rgw_pubsub_event_triggered, "pubsub_event_triggered", "Pubsub events with at least one topic");
   plb.add_u64_counter(l_rgw_pubsub_event_lost, "pubsub_event_lost", "Pubsub events lost");
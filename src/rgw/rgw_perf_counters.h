@@ -28,6 +28,9 @@ enum {
   l_rgw_cache_hit,
   l_rgw_cache_miss,
 
+  l_rgw_obj_head_cache_hit,
+  l_rgw_obj_head_cache_miss,
+
   l_rgw_keystone_token_cache_hit,
   l_rgw_keystone_token_cache_miss,
 
@@ -39,6 +42,9 @@ enum {
   l_rgw_lc_transition_current,
   l_rgw_lc_transition_noncurrent,
   l_rgw_lc_abort_mpu,
+  l_rgw_lc_processed,
+  l_rgw_lc_work_stolen,
+  l_rgw_lc_active_workers,
 
   l_rgw_pubsub_event_triggered,
   l_rgw_pubsub_event_lost,
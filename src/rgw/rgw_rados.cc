@@ -88,6 +88,8 @@
 #include "compressor/Compressor.h"
 
 #include "rgw_d3n_datacache.h"
+#include "rgw_perf_counters.h"
+#include "rgw_obj_head_cache.h"
 
 #ifdef WITH_LTTNG
 #define TRACEPOINT_DEFINE
@@ -243,6 +245,12 @@ void RGWObjectCtx::set_prefetch_data(const rgw_obj& obj) {
   objs_state[obj].state.prefetch_data = true;
 }
 
+void RGWObjectCtx::set_use_head_cache(const rgw_obj& obj) {
+  std::unique_lock wl{lock};
+  assert (!obj.empty());
+  objs_state[obj].state.use_head_cache = true;
+}
+
 void RGWObjectCtx::invalidate(const rgw_obj& obj) {
   std::unique_lock wl{lock};
   auto iter = objs_state.find(obj);
@@ -263,6 +271,13 @@ void RGWObjectCtx::invalidate(const rgw_obj& obj) {
   }
 }
 
+void RGWRados::invalidate_obj_head(const rgw_obj& obj)
+{
+  if (obj_head_cache) {
+    obj_head_cache->invalidate(obj);
+  }
+}
+
 void RGWObjVersionTracker::generate_new_write_ver(CephContext *cct)
 {
   write_version.ver = 1;
@@ -1092,6 +1107,7 @@ void RGWRados::finalize()
 
   delete binfo_cache;
   delete obj_tombstone_cache;
+  delete obj_head_cache;
   if (d3n_data_cache)
     delete d3n_data_cache;
 
@@ -1343,6 +1359,12 @@ int RGWRados::init_complete(const DoutPrefixProvider *dpp)
     obj_tombstone_cache = new tombstone_cache_t(cct->_conf->rgw_obj_tombstone_cache_size);
   }
 
+  const auto head_cache_ttl = cct->_conf.get_val<std::chrono::seconds>("rgw_obj_head_cache_ttl");
+  const auto head_cache_size = cct->_conf.get_val<uint64_t>("rgw_obj_head_cache_size");
+  if (head_cache_ttl.count() > 0 && head_cache_size > 0) {
+    obj_head_cache = new RGWObjHeadCache(head_cache_size, head_cache_ttl);
+  }
+
   reshard_wait = std::make_shared<RGWReshardWait>();
 
   reshard = new RGWReshard(this->store);
@@ -4485,22 +4507,47 @@ int RGWRados::copy_obj(RGWObjectCtx& obj_ctx,
     if (tail_placement.bucket.name.empty()) {
       manifest.set_tail_placement(tail_placement.placement_rule, src_obj->get_bucket()->get_key());
     }
-    string ref_tag;
+    // take the tail references concurrently; large objects have one
+    // tail object per stripe. only references known to be taken are
+    // recorded for the rollback
+    auto aio = rgw::make_throttle(
+      cct->_conf.get_val<uint64_t>("rgw_copy_obj_max_aio"), y);
+    std::vector<rgw_raw_obj> tail_objs;
+    auto take_refs = [&] (rgw::AioResultList&& completed) {
+      int r = 0;
+      for (auto& result : completed) {
+        if (result.result < 0) {
+          r = result.result;
+        } else {
+          ref_objs.push_back(tail_objs[result.id]);
+        }
+      }
+      return r;
+    };
+
+    const string ref_tag = tag + '\0';
     for (; miter != amanifest->obj_end(dpp); ++miter) {
       ObjectWriteOperation op;
-      ref_tag = tag + '\0';
       cls_refcount_get(op, ref_tag, true);
       const rgw_raw_obj& loc = miter.get_location().get_raw_obj(store);
 
-      auto& ioctx = ref.pool.ioctx();
-      ioctx.locator_set_key(loc.loc);
+      // the tail objects share the pool opened for the rollback; only the
+      // oid and locator differ per stripe
+      auto obj = svc.rados->obj(ref.pool, loc.oid);
+      obj.get_ref().obj.loc = loc.loc;
+      ref.pool.ioctx().locator_set_key(loc.loc);
 
-      ret = rgw_rados_operate(dpp, ioctx, loc.oid, &op, null_yield);
+      tail_objs.push_back(loc);
+      ret = take_refs(aio->get(obj, rgw::Aio::librados_op(std::move(op), y),
+                               1, tail_objs.size() - 1));
       if (ret < 0) {
+        take_refs(aio->drain());
         goto done_ret;
       }
-
-      ref_objs.push_back(loc);
+    }
+    ret = take_refs(aio->drain());
+    if (ret < 0) {
+      goto done_ret;
     }
 
     pmanifest = &manifest;
@@ -5489,8 +5536,40 @@ int RGWRados::get_obj_state_impl(const DoutPrefixProvider *dpp, RGWObjectCtx *rc
 
   int r = -ENOENT;
 
-  if (!assume_noent) {
+  RGWObjHeadCache *head_cache = nullptr;
+  if (s->use_head_cache && obj_head_cache &&
+      RGWObjHeadCache::is_cacheable(bucket_info, obj->get_obj())) {
+    head_cache = obj_head_cache;
+  }
+  obj_head_entry head;
+  if (assume_noent) {
+    // nothing to read
+  } else if (head_cache && head_cache->find(obj->get_obj(), head) &&
+             (!head.exists || !s->prefetch_data)) {
+    if (perfcounter) perfcounter->inc(l_rgw_obj_head_cache_hit);
+    ldpp_dout(dpp, 20) << "get_obj_state: found obj in head cache: obj=" << obj
+        << " exists=" << head.exists << dendl;
+    if (head.exists) {
+      r = 0;
+      s->size = head.size;
+      s->mtime = head.mtime;
+      s->epoch = head.epoch;
+      s->attrset = std::move(head.attrset);
+    }
+  } else {
+    const uint64_t gen = head_cache ? head_cache->get_gen(obj->get_obj()) : 0;
     r = RGWRados::raw_obj_stat(dpp, raw_obj, &s->size, &s->mtime, &s->epoch, &s->attrset, (s->prefetch_data ? &s->data : NULL), NULL, y);
+    if (head_cache && (r == 0 || r == -ENOENT)) {
+      if (perfcounter) perfcounter->inc(l_rgw_obj_head_cache_miss);
+      head.exists = (r == 0);
+      if (head.exists) {
+        head.size = s->size;
+        head.mtime = s->mtime;
+        head.epoch = s->epoch;
+        head.attrset = s->attrset;
+      }
+      head_cache->add(obj->get_obj(), gen, head);
+    }
   }
 
   if (r == -ENOENT) {
@@ -6001,6 +6080,7 @@ int RGWRados::set_attrs(const DoutPrefixProvider *dpp, void *ctx, RGWBucketInfo&
   op.mtime2(&mtime_ts);
   auto& ioctx = ref.pool.ioctx();
   r = rgw_rados_operate(dpp, ioctx, ref.obj.oid, &op, null_yield);
+  invalidate_obj_head(obj->get_obj());
   if (state) {
     if (r >= 0) {
       bufferlist acl_bl = attrs[RGW_ATTR_ACL];
@@ -6220,10 +6300,11 @@ int RGWRados::Bucket::UpdateIndex::guard_reshard(const DoutPrefixProvider *dpp,
 
 int RGWRados::Bucket::UpdateIndex::prepare(const DoutPrefixProvider *dpp, RGWModifyOp op, const string *write_tag, optional_yield y)
 {
+  RGWRados *store = target->get_store();
+  store->invalidate_obj_head(obj);
   if (blind) {
     return 0;
   }
-  RGWRados *store = target->get_store();
 
   if (write_tag && write_tag->length()) {
     optag = string(write_tag->c_str(), write_tag->length());
@@ -6254,10 +6335,11 @@ int RGWRados::Bucket::UpdateIndex::complete(const DoutPrefixProvider *dpp, int64
                                             list<rgw_obj_index_key> *remove_objs, const string *user_data,
                                             bool appendable)
 {
+  RGWRados *store = target->get_store();
+  store->invalidate_obj_head(obj);
   if (blind) {
     return 0;
   }
-  RGWRados *store = target->get_store();
   BucketShard *bs = nullptr;
 
   int ret = get_bucket_shard(&bs, dpp);
@@ -6301,10 +6383,11 @@ int RGWRados::Bucket::UpdateIndex::complete_del(const DoutPrefixProvider *dpp,
                                                 real_time& removed_mtime,
                                                 list<rgw_obj_index_key> *remove_objs)
 {
+  RGWRados *store = target->get_store();
+  store->invalidate_obj_head(obj);
   if (blind) {
     return 0;
   }
-  RGWRados *store = target->get_store();
   BucketShard *bs = nullptr;
 
   int ret = get_bucket_shard(&bs, dpp);
@@ -6325,10 +6408,11 @@ int RGWRados::Bucket::UpdateIndex::complete_del(const DoutPrefixProvider *dpp,
 int RGWRados::Bucket::UpdateIndex::cancel(const DoutPrefixProvider *dpp,
                                           list<rgw_obj_index_key> *remove_objs)
 {
+  RGWRados *store = target->get_store();
+  store->invalidate_obj_head(obj);
   if (blind) {
     return 0;
   }
-  RGWRados *store = target->get_store();
   BucketShard *bs;
 
   int ret = guard_reshard(dpp, obj, &bs, [&](BucketShard *bs) -> int {
@@ -8589,6 +8673,9 @@ int RGWRados::cls_bucket_list_ordered(const DoutPrefixProvider *dpp,
     " shard(s) for " << num_entries_per_shard << " entries to get " <<
     num_entries << " total entries" << dendl;
 
+  // smallest batch worth a round trip when a shard runs dry
+  constexpr uint32_t min_refill = 8;
+
   auto& ioctx = index_pool.ioctx();
   std::map<int, rgw_cls_list_ret> shard_list_results;
   cls_rgw_obj_key start_after_key(start_after.name, start_after.instance);
@@ -8610,17 +8697,21 @@ int RGWRados::cls_bucket_list_ordered(const DoutPrefixProvider *dpp,
     const std::string& oid_name;
     RGWRados::ent_map_t::iterator cursor;
     RGWRados::ent_map_t::iterator end;
+    // number of entries to ask for when this shard runs dry
+    uint32_t batch;
 
     // manages an iterator through a shard and provides other
     // accessors
     ShardTracker(size_t _shard_idx,
 		 rgw_cls_list_ret& _result,
-		 const std::string& _oid_name):
+		 const std::string& _oid_name,
+		 uint32_t _batch):
       shard_idx(_shard_idx),
       result(_result),
       oid_name(_oid_name),
       cursor(_result.dir.m.begin()),
-      end(_result.dir.m.end())
+      end(_result.dir.m.end()),
+      batch(_batch)
     {}
 
     inline const std::string& entry_name() const {
@@ -8641,6 +8732,11 @@ int RGWRados::cls_bucket_list_ordered(const DoutPrefixProvider *dpp,
     inline bool at_end() const {
       return cursor == end;
     }
+    void reset(rgw_cls_list_ret&& _result) {
+      result = std::move(_result);
+      cursor = result.dir.m.begin();
+      end = result.dir.m.end();
+    }
   }; // ShardTracker
 
   // add the next unique candidate, or return false if we reach the end
@@ -8659,7 +8755,8 @@ int RGWRados::cls_bucket_list_ordered(const DoutPrefixProvider *dpp,
   std::vector<ShardTracker> results_trackers;
   results_trackers.reserve(shard_list_results.size());
   for (auto& r : shard_list_results) {
-    results_trackers.emplace_back(r.first, r.second, shard_oids[r.first]);
+    results_trackers.emplace_back(r.first, r.second, shard_oids[r.first],
+				  num_entries_per_shard);
 
     // if any *one* shard's result is trucated, the entire result is
     // truncated
@@ -8684,10 +8781,12 @@ int RGWRados::cls_bucket_list_ordered(const DoutPrefixProvider *dpp,
     ++tracker_idx;
   }
 
-  rgw_bucket_dir_entry*
-    last_entry_visited = nullptr; // to set last_entry (marker)
+  // to set last_entry (marker); held by value since a refill replaces
+  // the shard results skipped entries live in
+  std::optional<rgw_obj_index_key> last_entry_visited;
   std::map<std::string, bufferlist> updates;
   uint32_t count = 0;
+  uint32_t refills = 0;
   while (count < num_entries && !candidates.empty()) {
     r = 0;
     // select the next entry in lexical order (first key in map);
@@ -8736,7 +8835,7 @@ int RGWRados::cls_bucket_list_ordered(const DoutPrefixProvider *dpp,
 	dirent.key << dendl;
 
       auto [it, inserted] = m.insert_or_assign(name, std::move(dirent));
-      last_entry_visited = &it->second;
+      last_entry_visited = it->second.key;
       if (inserted) {
 	++count;
       } else {
@@ -8747,7 +8846,7 @@ int RGWRados::cls_bucket_list_ordered(const DoutPrefixProvider *dpp,
     } else {
       ldpp_dout(dpp, 10) << __PRETTY_FUNCTION__ << ": skipping " <<
 	dirent.key.name << "[" << dirent.key.instance << "]" << dendl;
-      last_entry_visited = &tracker.dir_entry();
+      last_entry_visited = tracker.dir_entry().key;
     }
 
     // refresh the candidates map
@@ -8756,16 +8855,54 @@ int RGWRados::cls_bucket_list_ordered(const DoutPrefixProvider *dpp,
 
     next_candidate(cct, tracker, candidates, tracker_idx);
 
-    if (tracker.at_end() && tracker.is_truncated()) {
-      // once we exhaust one shard that is truncated, we need to stop,
-      // as we cannot be certain that one of the next entries needs to
-      // come from that shard; S3 and swift protocols allow returning
-      // fewer than what was requested
-      ldpp_dout(dpp, 10) << __PRETTY_FUNCTION__ <<
-	": stopped accumulating results at count=" << count <<
-	", dirent=\"" << dirent.key <<
-	"\", because its shard is untruncated and exhaused" << dendl;
-      break;
+    if (tracker.at_end() && tracker.is_truncated() && count < num_entries) {
+      // we cannot be certain that one of the next entries does not
+      // come from this exhausted shard, so pull the next batch from it
+      // alone rather than returning a short page, which would make the
+      // caller re-read every shard for the next page; the batch doubles
+      // each time a shard keeps winning the merge
+      cls_rgw_obj_key shard_start_after = tracker.result.marker;
+      if (shard_start_after.empty()) {
+	// older osds do not return a marker
+	shard_start_after = *last_entry_visited;
+      }
+      tracker.batch = std::min(std::max(tracker.batch * 2, min_refill),
+			       num_entries - count);
+
+      std::map<int, std::string> refill_oids = {
+	{ int(tracker.shard_idx), tracker.oid_name }
+      };
+      std::map<int, rgw_cls_list_ret> refill_results;
+      r = CLSRGWIssueBucketList(ioctx, shard_start_after, prefix, delimiter,
+				tracker.batch, list_versions, refill_oids,
+				refill_results, 1)();
+      if (r < 0) {
+	ldpp_dout(dpp, 0) << __PRETTY_FUNCTION__ <<
+	  ": refilling shard " << tracker.shard_idx << " of " <<
+	  bucket_info.bucket << " failed with r=" << r << dendl;
+	return r;
+      }
+      ++refills;
+
+      ldpp_dout(dpp, 20) << __PRETTY_FUNCTION__ <<
+	": refilled shard " << tracker.shard_idx << " after \"" <<
+	shard_start_after << "\" with " <<
+	refill_results[tracker.shard_idx].dir.m.size() << " entries" << dendl;
+
+      *cls_filtered =
+	*cls_filtered && refill_results[tracker.shard_idx].cls_filtered;
+      tracker.reset(std::move(refill_results[tracker.shard_idx]));
+      next_candidate(cct, tracker, candidates, tracker_idx);
+
+      if (tracker.at_end() && tracker.is_truncated()) {
+	// the shard made no progress; stop here, as S3 and swift allow
+	// returning fewer entries than requested
+	ldpp_dout(dpp, 10) << __PRETTY_FUNCTION__ <<
+	  ": stopped accumulating results at count=" << count <<
+	  " because shard " << tracker.shard_idx <<
+	  " is truncated and exhausted" << dendl;
+	break;
+      }
     }
   } // while we haven't provided requested # of result entries
 
@@ -8797,7 +8934,7 @@ int RGWRados::cls_bucket_list_ordered(const DoutPrefixProvider *dpp,
 
   ldpp_dout(dpp, 20) << __PRETTY_FUNCTION__ <<
     ": returning, count=" << count << ", is_truncated=" << *is_truncated <<
-    dendl;
+    ", shard refills=" << refills << dendl;
 
   if (*is_truncated && count < num_entries) {
     ldpp_dout(dpp, 10) << __PRETTY_FUNCTION__ <<
@@ -8805,8 +8942,8 @@ int RGWRados::cls_bucket_list_ordered(const DoutPrefixProvider *dpp,
       count << ", which is truncated" << dendl;
   }
 
-  if (last_entry_visited != nullptr && last_entry) {
-    *last_entry = last_entry_visited->key;
+  if (last_entry_visited && last_entry) {
+    *last_entry = *last_entry_visited;
     ldpp_dout(dpp, 20) << __PRETTY_FUNCTION__ <<
       ": returning, last_entry=" << *last_entry << dendl;
   } else {
@@ -205,6 +205,7 @@ public:
   void set_compressed(const rgw_obj& obj);
   void set_atomic(rgw_obj& obj);
   void set_prefetch_data(const rgw_obj& obj);
+  void set_use_head_cache(const rgw_obj& obj);
   void invalidate(const rgw_obj& obj);
 };
 
@@ -325,6 +326,8 @@ template <class K, class V>
 class lru_map;
 using tombstone_cache_t = lru_map<rgw_obj, tombstone_entry>;
 
+class RGWObjHeadCache;
+
 class RGWIndexCompletionManager;
 
 class RGWRados
@@ -424,6 +427,7 @@ protected:
   RGWChainedCacheImpl_bucket_info_entry *binfo_cache;
 
   tombstone_cache_t *obj_tombstone_cache;
+  RGWObjHeadCache *obj_head_cache{nullptr};
 
   librados::IoCtx gc_pool_ctx;        // .rgw.gc
   librados::IoCtx lc_pool_ctx;        // .rgw.lc
@@ -547,6 +551,7 @@ public:
   tombstone_cache_t *get_tombstone_cache() {
     return obj_tombstone_cache;
   }
+  void invalidate_obj_head(const rgw_obj& obj);
   const RGWSyncModuleInstanceRef& get_sync_module() {
     return sync_module;
   }
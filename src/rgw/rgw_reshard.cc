@@ -182,6 +182,94 @@ public:
 }; // class BucketReshardShard
 
 
+// lists the index entries of a source shard, keeping the next batch in
+// flight while the current one is copied
+class BucketReshardSourceShard {
+  RGWRados::BucketShard bs;
+  const int shard_id;
+  const uint32_t max_entries;
+  std::string marker;
+  librados::AioCompletion *completion = nullptr;
+  rgw_cls_bi_list_ret result;
+  int result_ret = 0;
+  bool done = false;
+
+  int issue_list() {
+    librados::ObjectReadOperation op;
+    cls_rgw_bi_list(op, "", marker, max_entries, &result, &result_ret);
+
+    completion = librados::Rados::aio_create_completion(nullptr, nullptr);
+    auto& ref = bs.bucket_obj.get_ref();
+    int ret = ref.pool.ioctx().aio_operate(ref.obj.oid, completion, &op,
+                                           nullptr);
+    if (ret < 0) {
+      completion->release();
+      completion = nullptr;
+    }
+    return ret;
+  }
+
+public:
+  BucketReshardSourceShard(rgw::sal::RadosStore *store, int shard_id,
+                           uint32_t max_entries) :
+    bs(store->getRados()), shard_id(shard_id), max_entries(max_entries)
+  {}
+
+  ~BucketReshardSourceShard() {
+    if (completion) {
+      completion->wait_for_complete();
+      completion->release();
+    }
+  }
+
+  int init(const DoutPrefixProvider *dpp, const RGWBucketInfo& bucket_info,
+           const rgw::bucket_index_layout_generation& index) {
+    int ret = bs.init(dpp, bucket_info, index, shard_id);
+    if (ret < 0) {
+      return ret;
+    }
+    return issue_list();
+  }
+
+  int get_shard_id() const {
+    return shard_id;
+  }
+
+  bool is_done() const {
+    return done;
+  }
+
+  // waits for the batch in flight and issues the next one
+  int get_next(std::list<rgw_cls_bi_entry> *entries) {
+    completion->wait_for_complete();
+    int ret = completion->get_return_value();
+    completion->release();
+    completion = nullptr;
+
+    if (ret == -ENOENT) {
+      done = true;
+      return 0;
+    }
+    if (ret < 0) {
+      return ret;
+    }
+    if (result_ret < 0) {
+      return result_ret;
+    }
+
+    entries->swap(result.entries);
+    result.entries.clear();
+    if (!result.is_truncated || entries->empty()) {
+      done = true;
+      return 0;
+    }
+
+    marker = entries->back().idx;
+    return issue_list();
+  }
+}; // class BucketReshardSourceShard
+
+
 class BucketReshardManager {
   rgw::sal::RadosStore *store;
   deque<librados::AioCompletion *> completions;
@@ -821,16 +909,35 @@ int RGWBucketReshard::do_reshard(const rgw::bucket_index_layout_generation& curr
     (*out) << "total entries:";
   }
 
+  const auto start = ceph::mono_clock::now();
+
+  // source shards are listed concurrently, each with its next batch in
+  // flight while the current one is copied, and are served round-robin
   const int num_source_shards = current.layout.normal.num_shards;
-  string marker;
-  for (int i = 0; i < num_source_shards; ++i) {
-    bool is_truncated = true;
-    marker.clear();
-    const std::string null_object_filter; // empty string since we're not filtering by object
-    while (is_truncated) {
+  const size_t max_source_shards =
+    store->ctx()->_conf.get_val<uint64_t>("rgw_reshard_source_shard_concurrency");
+  std::deque<std::unique_ptr<BucketReshardSourceShard>> source_shards;
+  int next_source_shard = 0;
+  while (!source_shards.empty() || next_source_shard < num_source_shards) {
+    while (source_shards.size() < max_source_shards &&
+           next_source_shard < num_source_shards) {
+      auto source = std::make_unique<BucketReshardSourceShard>(
+        store, next_source_shard++, max_entries);
+      int ret = source->init(dpp, bucket_info, current);
+      if (ret < 0) {
+        derr << "ERROR: bi_list(): " << cpp_strerror(-ret) << dendl;
+        return ret;
+      }
+      source_shards.push_back(std::move(source));
+    }
+
+    auto source = std::move(source_shards.front());
+    source_shards.pop_front();
+    const int i = source->get_shard_id();
+    {
       entries.clear();
-      int ret = store->getRados()->bi_list(dpp, bucket_info, i, null_object_filter, marker, max_entries, &entries, &is_truncated);
-      if (ret < 0 && ret != -ENOENT) {
+      int ret = source->get_next(&entries);
+      if (ret < 0) {
         derr << "ERROR: bi_list(): " << cpp_strerror(-ret) << dendl;
         return ret;
       }
@@ -846,8 +953,6 @@ int RGWBucketReshard::do_reshard(const rgw::bucket_index_layout_generation& curr
 	}
 	total_entries++;
 
-	marker = entry.idx;
-
 	int target_shard_id;
 	cls_rgw_obj_key cls_key;
 	RGWObjCategory category;
@@ -858,7 +963,7 @@ int RGWBucketReshard::do_reshard(const rgw::bucket_index_layout_generation& curr
 	  // bogus entry created by https://tracker.ceph.com/issues/46456
 	  // to fix, skip so it doesn't get include in the new bucket instance
 	  total_entries--;
-	  ldpp_dout(dpp, 10) << "Dropping entry with empty name, idx=" << marker << dendl;
+	  ldpp_dout(dpp, 10) << "Dropping entry with empty name, idx=" << entry.idx << dendl;
 	  continue;
 	}
 	rgw_obj obj(bucket_info.bucket, key);
@@ -906,6 +1011,10 @@ int RGWBucketReshard::do_reshard(const rgw::bucket_index_layout_generation& curr
 	}
       } // entries loop
     }
+
+    if (!source->is_done()) {
+      source_shards.push_back(std::move(source));
+    }
   }
 
   if (verbose_json_out) {
@@ -920,6 +1029,12 @@ int RGWBucketReshard::do_reshard(const rgw::bucket_index_layout_generation& curr
     ldpp_dout(dpp, -1) << "ERROR: failed to reshard" << dendl;
     return -EIO;
   }
+
+  ldpp_dout(dpp, 1) << __func__ << " INFO: copied " << total_entries <<
+    " entries of bucket \"" << bucket_info.bucket.name << "\" from " <<
+    num_source_shards << " shards in " <<
+    std::chrono::duration<double>(ceph::mono_clock::now() - start).count() <<
+    "s" << dendl;
   return 0;
 } // RGWBucketReshard::do_reshard
 
@@ -260,6 +260,7 @@ void aws_response_handler::send_stats_response()
 
 RGWSelectObj_ObjStore_S3::RGWSelectObj_ObjStore_S3():
   m_buff_header(std::make_unique<char[]>(1000)),
+  m_csv_query_set(false),
   m_parquet_type(false),
   chunk_number(0)
 {
@@ -334,47 +335,52 @@ int RGWSelectObj_ObjStore_S3::run_s3select(const char* query, const char* input,
   const char* s3select_resource_id = "resourcse-id";
   const char* s3select_processTime_error = "s3select-ProcessingTime-Error";
 
-  s3select_syntax.parse_query(query);
-  if (m_row_delimiter.size()) {
-    csv.row_delimiter = *m_row_delimiter.c_str();
-  }
-  if (m_column_delimiter.size()) {
-    csv.column_delimiter = *m_column_delimiter.c_str();
-  }
-  if (m_quot.size()) {
-    csv.quot_char = *m_quot.c_str();
-  }
-  if (m_escape_char.size()) {
-    csv.escape_char = *m_escape_char.c_str();
-  }
-  if (m_enable_progress.compare("true")==0) {
-    enable_progress = true;
-  } else {
-    enable_progress = false;
-  }
-  if (output_row_delimiter.size()) {
-    csv.output_row_delimiter = *output_row_delimiter.c_str();
-  }
-  if (output_column_delimiter.size()) {
-    csv.output_column_delimiter = *output_column_delimiter.c_str();
-  }
-  if (output_quot.size()) {
-    csv.output_quot_char = *output_quot.c_str();
-  }
-  if (output_escape_char.size()) {
-    csv.output_escape_char = *output_escape_char.c_str();
-  }
-  if(output_quote_fields.compare("ALWAYS") == 0) {
-    csv.quote_fields_always = true;
-  } else if(output_quote_fields.compare("ASNEEDED") == 0) {
-    csv.quote_fields_asneeded = true;
-  }
-  if(m_header_info.compare("IGNORE")==0) {
-    csv.ignore_header_info=true;
-  } else if(m_header_info.compare("USE")==0) {
-    csv.use_header_info=true;
+  //the query and the csv definitions do not change between chunks; parsing them
+  //again for every chunk costs more than the chunk itself on small segments
+  if (!m_csv_query_set) {
+    s3select_syntax.parse_query(query);
+    if (m_row_delimiter.size()) {
+      csv.row_delimiter = *m_row_delimiter.c_str();
+    }
+    if (m_column_delimiter.size()) {
+      csv.column_delimiter = *m_column_delimiter.c_str();
+    }
+    if (m_quot.size()) {
+      csv.quot_char = *m_quot.c_str();
+    }
+    if (m_escape_char.size()) {
+      csv.escape_char = *m_escape_char.c_str();
+    }
+    if (m_enable_progress.compare("true")==0) {
+      enable_progress = true;
+    } else {
+      enable_progress = false;
+    }
+    if (output_row_delimiter.size()) {
+      csv.output_row_delimiter = *output_row_delimiter.c_str();
+    }
+    if (output_column_delimiter.size()) {
+      csv.output_column_delimiter = *output_column_delimiter.c_str();
+    }
+    if (output_quot.size()) {
+      csv.output_quot_char = *output_quot.c_str();
+    }
+    if (output_escape_char.size()) {
+      csv.output_escape_char = *output_escape_char.c_str();
+    }
+    if(output_quote_fields.compare("ALWAYS") == 0) {
+      csv.quote_fields_always = true;
+    } else if(output_quote_fields.compare("ASNEEDED") == 0) {
+      csv.quote_fields_asneeded = true;
+    }
+    if(m_header_info.compare("IGNORE")==0) {
+      csv.ignore_header_info=true;
+    } else if(m_header_info.compare("USE")==0) {
+      csv.use_header_info=true;
+    }
+    m_s3_csv_object.set_csv_query(&s3select_syntax, csv);
+    m_csv_query_set = true;
   }
-  m_s3_csv_object.set_csv_query(&s3select_syntax, csv);
   m_aws_response_handler.init_response();
   if (s3select_syntax.get_error_description().empty() == false) {
     //error-flow (syntax-error)
@@ -620,6 +626,32 @@ int RGWSelectObj_ObjStore_S3::parquet_processing(bufferlist& bl, off_t ofs, off_
     return 0;
 }
 
+int RGWSelectObj_ObjStore_S3::csv_process_block(const char* input, size_t input_length)
+{
+  //rados hands over segments that may be much smaller than a stripe. every call into
+  //the engine re-enters the csv parser and frames its own response message, so small
+  //segments are gathered into blocks of rgw_s3select_csv_block_size bytes first.
+  //segments that are large enough are processed in place, without a copy.
+  const size_t block_size = s->cct->_conf->rgw_s3select_csv_block_size;
+  bool last = m_aws_response_handler.get_processed_size() + m_csv_block.size() + input_length >= s->obj_size;
+  if (m_csv_block.empty() && (input_length >= block_size || last)) {
+    m_aws_response_handler.update_processed_size(input_length);
+    return run_s3select(m_sql_query.c_str(), input, input_length);
+  }
+  if (m_csv_block.capacity() < block_size) {
+    m_csv_block.reserve(block_size);
+  }
+  m_csv_block.append(input, input_length);
+  if (m_csv_block.size() < block_size && !last) {
+    return 0;
+  }
+  ldpp_dout(this, 10) << "s3select: processing block of " << m_csv_block.size() << " bytes" << dendl;
+  m_aws_response_handler.update_processed_size(m_csv_block.size());
+  int status = run_s3select(m_sql_query.c_str(), m_csv_block.data(), m_csv_block.size());
+  m_csv_block.clear();
+  return status;
+}
+
 int RGWSelectObj_ObjStore_S3::csv_processing(bufferlist& bl, off_t ofs, off_t len)
 {
   int status = 0;
@@ -629,20 +661,25 @@ int RGWSelectObj_ObjStore_S3::csv_processing(bufferlist& bl, off_t ofs, off_t le
   } else {
     auto bl_len = bl.get_num_buffers();
     int i=0;
+    off_t seg_ofs = 0;
     for(auto& it : bl.buffers()) {
       ldpp_dout(this, 10) << "processing segment " << i << " out of " << bl_len << " off " << ofs
                           << " len " << len << " obj-size " << s->obj_size << dendl;
-      if(it.length() == 0) {
-        ldpp_dout(this, 10) << "s3select:it->_len is zero. segment " << i << " out of " << bl_len
+      //only the [ofs, ofs + len) part of bl belongs to this callback
+      off_t seg_start = std::max<off_t>(ofs, seg_ofs);
+      off_t seg_end = std::min<off_t>(ofs + len, seg_ofs + it.length());
+      off_t seg_base = seg_ofs;
+      seg_ofs += it.length();
+      i++;
+      if(seg_start >= seg_end) {
+        ldpp_dout(this, 10) << "s3select: nothing to process in segment " << i << " out of " << bl_len
                             <<  " obj-size " << s->obj_size << dendl;
         continue;
       }
-      m_aws_response_handler.update_processed_size(it.length());
-      status = run_s3select(m_sql_query.c_str(), &(it)[0], it.length());
+      status = csv_process_block(&(it)[0] + (seg_start - seg_base), seg_end - seg_start);
       if(status<0) {
         break;
       }
-      i++;
     }
   }
   if (m_aws_response_handler.get_processed_size() == s->obj_size) {
@@ -185,6 +185,10 @@ private:
   std::string output_row_delimiter;
   aws_response_handler m_aws_response_handler;
   bool enable_progress;
+  //the query is parsed and bound to the csv object once per request
+  bool m_csv_query_set;
+  //small segments are gathered here before they are handed to the engine
+  std::string m_csv_block;
 
   //parquet request
   bool m_parquet_type;
@@ -215,6 +219,8 @@ private:
 
   int csv_processing(bufferlist& bl, off_t ofs, off_t len);
 
+  int csv_process_block(const char* input, size_t input_length);
+
   int parquet_processing(bufferlist& bl, off_t ofs, off_t len);
 
   int run_s3select(const char* query, const char* input, size_t input_length);
@@ -80,6 +80,7 @@ RGWObjState::RGWObjState(const RGWObjState& rhs) : obj (rhs.obj) {
   objv_tracker = rhs.objv_tracker;
   pg_ver = rhs.pg_ver;
   compressed = rhs.compressed;
+  use_head_cache = rhs.use_head_cache;
 }
 
 rgw::sal::Store* StoreManager::init_storage_provider(const DoutPrefixProvider* dpp, CephContext* cct, const std::string svc, const std::string filter, bool use_gc_thread, bool use_lc_thread, bool quota_threads, bool run_sync_thread, bool run_reshard_thread, bool use_cache, bool use_gc)
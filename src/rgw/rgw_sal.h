@@ -128,6 +128,7 @@ struct RGWObjState {
   uint64_t pg_ver{false};
   uint32_t zone_short_id{0};
   bool compressed{false};
+  bool use_head_cache{false}; //< loads may be served from the head cache
 
   /* important! don't forget to update copy constructor */
 
@@ -961,6 +962,10 @@ class Object {
     virtual void set_prefetch_data() = 0;
     /** Check if this object should prefetch */
     virtual bool is_prefetch_data() = 0;
+    /** Allow loads of this object's head to be served from a cache that may
+     * lag behind changes made through other gateways.  Only for requests
+     * that just read the object, such as GET and HEAD */
+    virtual void set_use_head_cache() = 0;
     /** Mark data as compressed */
     virtual void set_compressed() = 0;
     /** Check if this object is compressed */
@@ -572,6 +572,7 @@ public:
   virtual bool is_atomic() override { return next->is_atomic(); }
   virtual void set_prefetch_data() override { return next->set_prefetch_data(); }
   virtual bool is_prefetch_data() override { return next->is_prefetch_data(); }
+  virtual void set_use_head_cache() override { return next->set_use_head_cache(); }
   virtual void set_compressed() override { return next->set_compressed(); }
   virtual bool is_compressed() override { return next->is_compressed(); }
   virtual void invalidate() override { return next->invalidate(); }
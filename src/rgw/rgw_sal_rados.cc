@@ -1510,7 +1510,8 @@ std::unique_ptr<Writer> RadosStore::get_append_writer(const DoutPrefixProvider *
 				  uint64_t position,
 				  uint64_t *cur_accounted_size)
 {
-  auto aio = rgw::make_throttle(ctx()->_conf->rgw_put_obj_min_window_size, y);
+  auto aio = rgw::make_throttle(ctx()->_conf->rgw_put_obj_min_window_size, y,
+                                ctx()->_conf->rgw_put_obj_max_window_size);
   return std::make_unique<RadosAppendWriter>(dpp, y,
 				 std::move(_head_obj),
 				 this, std::move(aio), owner,
@@ -1527,7 +1528,8 @@ std::unique_ptr<Writer> RadosStore::get_atomic_writer(const DoutPrefixProvider *
 				  uint64_t olh_epoch,
 				  const std::string& unique_tag)
 {
-  auto aio = rgw::make_throttle(ctx()->_conf->rgw_put_obj_min_window_size, y);
+  auto aio = rgw::make_throttle(ctx()->_conf->rgw_put_obj_min_window_size, y,
+                                ctx()->_conf->rgw_put_obj_max_window_size);
   return std::make_unique<RadosAtomicWriter>(dpp, y,
 				 std::move(_head_obj),
 				 this, std::move(aio), owner,
@@ -2417,7 +2419,10 @@ int RadosMultipartUpload::complete(const DoutPrefixProvider *dpp,
 
   int total_parts = 0;
   int handled_parts = 0;
-  int max_parts = 1000;
+  // the number of parts is known, so list them all at once; uploads
+  // from older gateways keep their parts unsorted and every listing
+  // call would read all of them again
+  int max_parts = std::max<int>(1000, part_etags.size());
   int marker = 0;
   uint64_t min_part_size = cct->_conf->rgw_multipart_min_part_size;
   auto etags_iter = part_etags.begin();
@@ -2653,7 +2658,8 @@ std::unique_ptr<Writer> RadosMultipartUpload::get_writer(
 				  uint64_t part_num,
 				  const std::string& part_num_str)
 {
-  auto aio = rgw::make_throttle(store->ctx()->_conf->rgw_put_obj_min_window_size, y);
+  auto aio = rgw::make_throttle(store->ctx()->_conf->rgw_put_obj_min_window_size, y,
+                                store->ctx()->_conf->rgw_put_obj_max_window_size);
   return std::make_unique<RadosMultipartWriter>(dpp, y, this,
 				 std::move(_head_obj), store, std::move(aio), owner,
 				 ptail_placement_rule, part_num, part_num_str);
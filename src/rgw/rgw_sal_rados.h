@@ -408,6 +408,10 @@ class RadosObject : public StoreObject {
       rados_ctx->set_prefetch_data(state.obj);
       StoreObject::set_prefetch_data();
     }
+    virtual void set_use_head_cache() override {
+      rados_ctx->set_use_head_cache(state.obj);
+      StoreObject::set_use_head_cache();
+    }
     virtual void set_compressed() override {
       rados_ctx->set_compressed(state.obj);
       StoreObject::set_compressed();
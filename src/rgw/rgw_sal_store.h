@@ -192,6 +192,7 @@ class StoreObject : public Object {
     virtual bool is_atomic() override { return state.is_atomic; }
     virtual void set_prefetch_data() override { state.prefetch_data = true; }
     virtual bool is_prefetch_data() override { return state.prefetch_data; }
+    virtual void set_use_head_cache() override { state.use_head_cache = true; }
     virtual void set_compressed() override { state.compressed = true; }
     virtual bool is_compressed() override { return state.compressed; }
     virtual void invalidate() override {
@@ -60,6 +60,24 @@ TEST(MD5, Restart) {
   ASSERT_EQ(0, err);
 }
 
+TEST(MD5, BufferListUpdate) {
+  ceph::bufferlist bl;
+  bl.append(ceph::buffer::copy("f", 1));
+  bl.append(ceph::buffer::copy("oo", 2));
+  ASSERT_EQ(2u, bl.get_num_buffers());
+  ceph::crypto::MD5 h;
+  h.Update(bl);
+  unsigned char digest[CEPH_CRYPTO_MD5_DIGESTSIZE];
+  h.Final(digest);
+  int err;
+  unsigned char want_digest[CEPH_CRYPTO_MD5_DIGESTSIZE] = {
+    0xac, 0xbd, 0x18, 0xdb, 0x4c, 0xc2, 0xf8, 0x5c,
+    0xed, 0xef, 0x65, 0x4f, 0xcc, 0xc4, 0xa4, 0xd8,
+  };
+  err = memcmp(digest, want_digest, CEPH_CRYPTO_MD5_DIGESTSIZE);
+  ASSERT_EQ(0, err);
+}
+
 TEST(HMACSHA1, Simple) {
   ceph::crypto::HMACSHA1 h((const unsigned char*)"sekrit", 6);
   h.Update((const unsigned char*)"foo", 3);
@@ -583,18 +583,18 @@ TEST_F(cls_rgw, index_list_delimited)
   auto id_entry_map = it->second.dir.m;
   bool truncated = it->second.is_truncated;
 
-  // the cls code will make 4 tries to get 1000 entries; however
-  // because each of the subdirectories is so large, each attempt will
-  // only retrieve the first part of the subdirectory
+  // the first read of 1000 entries ends inside the first large
+  // subdirectory; from then on the cls code seeks past each
+  // subdirectory with small reads, so all entries fit in one call
 
-  ASSERT_EQ(48u, id_entry_map.size()) <<
-    "We should get 40 top-level entries and the tops of 8 \"subdirectories\".";
-  ASSERT_EQ(true, truncated) << "We did not get all entries.";
+  ASSERT_EQ(65u, id_entry_map.size()) <<
+    "We should get 55 top-level entries and 10 \"subdirectories\".";
+  ASSERT_EQ(false, truncated) << "We should have all entries.";
 
   ASSERT_EQ("a-0", id_entry_map.cbegin()->first);
-  ASSERT_EQ("p/", id_entry_map.crbegin()->first);
+  ASSERT_EQ("u-4", id_entry_map.crbegin()->first);
 
-  // now let's get the rest of the entries
+  // listing after a subdirectory skips past it
 
   list_results.clear();
   
@@ -616,6 +616,93 @@ TEST_F(cls_rgw, index_list_delimited)
   ASSERT_EQ("u-4", id_entry_map.crbegin()->first);
 }
 
+TEST_F(cls_rgw, index_list_delimited_seek_limit)
+{
+  string bucket_oid = str_int("bucket", 8);
+
+  ObjectWriteOperation op;
+  cls_rgw_bucket_init_index(op);
+  ASSERT_EQ(0, ioctx.operate(bucket_oid, &op));
+
+  uint64_t epoch = 1;
+  uint64_t obj_size = 1024;
+  const int big_dir_num_objs = 1005;
+  const int num_dirs = 100;
+  const int dir_num_objs = 10;
+
+  rgw_bucket_dir_entry_meta meta;
+  meta.category = RGWObjCategory::None;
+  meta.size = obj_size;
+
+  auto add_obj = [&](const string& obj, int i) {
+    string tag = str_int("tag", i);
+    string loc = str_int("loc", i);
+
+    index_prepare(ioctx, bucket_oid, CLS_RGW_OP_ADD, tag, obj, loc,
+		  0 /* bi_flags */, false /* log_op */);
+
+    index_complete(ioctx, bucket_oid, CLS_RGW_OP_ADD, tag, epoch, obj, meta,
+		   0 /* bi_flags */, false /* log_op */);
+  };
+
+  // the first read ends inside "a/", after which every small seek read
+  // ends inside the next subdirectory
+  for (int i = 0; i < big_dir_num_objs; i++) {
+    add_obj("a/" + str_int("f", i), i);
+  }
+  for (int d = 0; d < num_dirs; d++) {
+    const string dir = str_int("d", d) + "/";
+    for (int i = 0; i < dir_num_objs; i++) {
+      add_obj(dir + str_int("f", i), i);
+    }
+  }
+
+  map<int, string> oids = { {0, bucket_oid} };
+  map<int, struct rgw_cls_list_ret> list_results;
+  cls_rgw_obj_key start_key("", "");
+  const string empty_prefix;
+  const string delimiter = "/";
+  int r = CLSRGWIssueBucketList(ioctx, start_key,
+				empty_prefix, delimiter,
+				1000, true, oids, list_results, 1)();
+  ASSERT_EQ(r, 0);
+
+  auto it = list_results.begin();
+  auto id_entry_map = it->second.dir.m;
+  bool truncated = it->second.is_truncated;
+
+  // the cls code stops after 64 seek reads, each of which found one
+  // more subdirectory
+  ASSERT_EQ(65u, id_entry_map.size()) <<
+    "We should get \"a/\" and 64 more \"subdirectories\".";
+  ASSERT_EQ(true, truncated) << "We did not get all entries.";
+  ASSERT_EQ("a/", id_entry_map.cbegin()->first);
+
+  // the rest of the entries are returned from the marker
+  cls_rgw_obj_key marker = it->second.marker;
+  std::set<string> prefixes;
+  for (auto& e : id_entry_map) {
+    prefixes.insert(e.first);
+  }
+  list_results.clear();
+
+  r = CLSRGWIssueBucketList(ioctx, marker,
+			    empty_prefix, delimiter,
+			    1000, true, oids, list_results, 1)();
+  ASSERT_EQ(r, 0);
+
+  it = list_results.begin();
+  id_entry_map = it->second.dir.m;
+  truncated = it->second.is_truncated;
+
+  ASSERT_EQ(36u, id_entry_map.size());
+  ASSERT_EQ(false, truncated) << "We now have all entries.";
+  for (auto& e : id_entry_map) {
+    ASSERT_TRUE(prefixes.insert(e.first).second) << e.first;
+  }
+  ASSERT_EQ(size_t(num_dirs + 1), prefixes.size());
+}
+
 
 TEST_F(cls_rgw, bi_list)
 {
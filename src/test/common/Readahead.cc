@@ -130,3 +130,50 @@ TEST(Readahead, alignment) {
   ASSERT_RA(1400, 300, r.update(1290, 10, Readahead::NO_LIMIT)); // internal readahead size 320
   ASSERT_RA(0, 0, r.update(1300, 10, Readahead::NO_LIMIT));
 }
+
+TEST(Readahead, multiple_streams) {
+  Readahead r;
+  r.set_trigger_requests(2);
+  r.set_max_streams(2);
+  ASSERT_RA(0, 0, r.update(1000, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(0, 0, r.update(5000, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(0, 0, r.update(1010, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(0, 0, r.update(5010, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(1030, 20, r.update(1020, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(5030, 20, r.update(5020, 10, Readahead::NO_LIMIT));
+
+  // a third stream evicts the least recently used one
+  ASSERT_RA(0, 0, r.update(9000, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(5050, 40, r.update(5030, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(0, 0, r.update(1030, 10, Readahead::NO_LIMIT));
+}
+
+TEST(Readahead, single_stream_interleaved) {
+  Readahead r;
+  r.set_trigger_requests(2);
+  ASSERT_RA(0, 0, r.update(1000, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(0, 0, r.update(5000, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(0, 0, r.update(1010, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(0, 0, r.update(5010, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(0, 0, r.update(1020, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(0, 0, r.update(5020, 10, Readahead::NO_LIMIT));
+}
+
+TEST(Readahead, prefetch_stats) {
+  Readahead r;
+  r.set_trigger_requests(2);
+  ASSERT_RA(0, 0, r.update(1000, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(0, 0, r.update(1010, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(1030, 20, r.update(1020, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(1050, 40, r.update(1030, 10, Readahead::NO_LIMIT));
+
+  auto stats = r.pop_prefetch_stats();
+  ASSERT_EQ(10U, stats.useful_bytes);
+  ASSERT_EQ(0U, stats.wasted_bytes);
+
+  // abandoning the stream wastes the unread part of 1040~50
+  ASSERT_RA(0, 0, r.update(3000, 10, Readahead::NO_LIMIT));
+  stats = r.pop_prefetch_stats();
+  ASSERT_EQ(0U, stats.useful_bytes);
+  ASSERT_EQ(50U, stats.wasted_bytes);
+}
@@ -31,6 +31,7 @@
 #include "gtest/gtest.h"
 #include "common/Thread.h"
 #include "common/Throttle.h"
+#include "common/Timer.h"
 #include "common/ceph_argparse.h"
 
 using namespace std;
@@ -375,6 +376,74 @@ TEST(BackoffThrottle, oversaturated)
   ASSERT_GT(results.second.count(), 0.0005);
 }
 
+struct TokenBucketWaiter {
+  ceph::mutex lock = ceph::make_mutex("TokenBucketWaiter::lock");
+  ceph::condition_variable cond;
+  int completed = 0;
+
+  void handle(int item, uint64_t flag) {
+    std::lock_guard l{lock};
+    ++completed;
+    cond.notify_all();
+  }
+};
+
+TEST(TokenBucketThrottle, resume_after_idle)
+{
+  ceph::mutex timer_lock = ceph::make_mutex("TokenBucketThrottle::timer_lock");
+  SafeTimer timer(g_ceph_context, timer_lock, true);
+  timer.init();
+  {
+    TokenBucketThrottle throttle(g_ceph_context, "token_bucket_test", 0, 0,
+                                 &timer, &timer_lock);
+    ASSERT_EQ(0, throttle.set_limit(100, 0, 1));
+
+    // let the bucket fill up so that the refill timer goes idle
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+
+    TokenBucketWaiter waiter;
+    ASSERT_TRUE(throttle.get(150, &waiter, &TokenBucketWaiter::handle, 0, 0));
+
+    // the remaining tokens only arrive if get() restarted the timer
+    std::unique_lock l{waiter.lock};
+    ASSERT_TRUE(waiter.cond.wait_for(l, std::chrono::seconds(5),
+                                     [&waiter] { return waiter.completed > 0; }));
+  }
+  {
+    std::lock_guard l{timer_lock};
+    timer.shutdown();
+  }
+}
+
+TEST(TokenBucketThrottle, resume_without_timer_lock)
+{
+  ceph::mutex timer_lock = ceph::make_mutex("TokenBucketThrottle::timer_lock");
+  SafeTimer timer(g_ceph_context, timer_lock, true);
+  timer.init();
+  {
+    TokenBucketThrottle throttle(g_ceph_context, "token_bucket_test", 0, 0,
+                                 &timer, &timer_lock);
+    ASSERT_EQ(0, throttle.set_limit(100, 0, 1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+
+    // blocker callbacks run under the timer lock, so a caller may hold a lock
+    // they take too; get() must restart the timer without blocking on it
+    TokenBucketWaiter waiter;
+    {
+      std::lock_guard timer_locker{timer_lock};
+      ASSERT_TRUE(throttle.get(150, &waiter, &TokenBucketWaiter::handle, 0, 0));
+    }
+
+    std::unique_lock l{waiter.lock};
+    ASSERT_TRUE(waiter.cond.wait_for(l, std::chrono::seconds(5),
+                                     [&waiter] { return waiter.completed > 0; }));
+  }
+  {
+    std::lock_guard l{timer_lock};
+    timer.shutdown();
+  }
+}
+
 /*
  * Local Variables:
  * compile-command: "cd ../.. ;
@@ -0,0 +1,180 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#include <memory>
+
+#include "common/PriorityCache.h"
+#include "common/ceph_context.h"
+#include "global/global_context.h"
+#include "gtest/gtest.h"
+
+using namespace PriorityCache;
+
+namespace {
+
+struct FakeCache : public PriCache {
+  int64_t cache_bytes[Priority::LAST + 1] = {0};
+  int64_t committed = 64 << 20;
+  double ratio = 0;
+  bool has_stats = true;
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+
+  FakeCache(double r) : ratio(r) {}
+
+  int64_t request_cache_bytes(Priority pri, uint64_t total) const override {
+    return 0;
+  }
+  int64_t get_cache_bytes(Priority pri) const override {
+    return cache_bytes[pri];
+  }
+  int64_t get_cache_bytes() const override {
+    int64_t total = 0;
+    for (auto b : cache_bytes) {
+      total += b;
+    }
+    return total;
+  }
+  void set_cache_bytes(Priority pri, int64_t bytes) override {
+    cache_bytes[pri] = bytes;
+  }
+  void add_cache_bytes(Priority pri, int64_t bytes) override {
+    cache_bytes[pri] += bytes;
+  }
+  int64_t commit_cache_size(uint64_t total) override {
+    return committed;
+  }
+  int64_t get_committed_size() const override {
+    return committed;
+  }
+  double get_cache_ratio() const override {
+    return ratio;
+  }
+  void set_cache_ratio(double r) override {
+    ratio = r;
+  }
+  std::string get_cache_name() const override {
+    return "fake";
+  }
+  void shift_bins() override {}
+  void import_bins(const std::vector<uint64_t> &bins) override {}
+  void set_bins(Priority pri, uint64_t end_bin) override {}
+  uint64_t get_bins(Priority pri) const override {
+    return 0;
+  }
+  bool get_hit_stats(uint64_t *h, uint64_t *m) const override {
+    *h = hits;
+    *m = misses;
+    return has_stats;
+  }
+};
+
+} // anonymous namespace
+
+TEST(PriorityCache, TuneRatiosFollowsMisses)
+{
+  Manager m(g_ceph_context, 1 << 30, 1 << 30, 1 << 30, false,
+            "test-pricache-follow");
+  auto a = std::make_shared<FakeCache>(0.5);
+  auto b = std::make_shared<FakeCache>(0.5);
+  m.insert("a", a, false);
+  m.insert("b", b, false);
+
+  // the first round only primes the counters
+  m.tune_ratios(0.1, 4);
+  ASSERT_DOUBLE_EQ(0.5, a->get_cache_ratio());
+  ASSERT_DOUBLE_EQ(0.5, b->get_cache_ratio());
+
+  // "b" misses far more per byte than "a": it should grow, round after
+  // round, until it hits the skew limit, and the sum must be preserved
+  double prev = 0.5;
+  for (int i = 0; i < 100; ++i) {
+    a->set_cache_ratio(0.5);
+    b->set_cache_ratio(0.5);
+    a->hits += 1000;
+    a->misses += 10;
+    b->hits += 1000;
+    b->misses += 500;
+    m.tune_ratios(0.1, 4);
+    ASSERT_GE(b->get_cache_ratio(), prev);
+    ASSERT_NEAR(1.0, a->get_cache_ratio() + b->get_cache_ratio(), 1e-9);
+    ASSERT_GE(a->get_cache_ratio(), 0.5 / 4 - 1e-9);
+    prev = b->get_cache_ratio();
+  }
+  // the tuned ratios stay within [1/4, 4] of the configured ones, even
+  // after renormalizing: "a" is pinned at its lower bound
+  ASSERT_NEAR(0.5 / 4, a->get_cache_ratio(), 1e-9);
+  ASSERT_NEAR(1 - 0.5 / 4, b->get_cache_ratio(), 1e-9);
+
+  // the workload flips; memory flows back
+  for (int i = 0; i < 100; ++i) {
+    a->set_cache_ratio(0.5);
+    b->set_cache_ratio(0.5);
+    a->misses += 500;
+    b->misses += 10;
+    m.tune_ratios(0.1, 4);
+  }
+  ASSERT_GT(a->get_cache_ratio(), b->get_cache_ratio());
+}
+
+TEST(PriorityCache, TuneRatiosSkipsCachesWithoutStats)
+{
+  Manager m(g_ceph_context, 1 << 30, 1 << 30, 1 << 30, false,
+            "test-pricache-skip");
+  auto a = std::make_shared<FakeCache>(0.25);
+  auto b = std::make_shared<FakeCache>(0.25);
+  auto c = std::make_shared<FakeCache>(0.5);
+  c->has_stats = false;
+  m.insert("a", a, false);
+  m.insert("b", b, false);
+  m.insert("c", c, false);
+
+  for (int i = 0; i < 10; ++i) {
+    a->set_cache_ratio(0.25);
+    b->set_cache_ratio(0.25);
+    c->set_cache_ratio(0.5);
+    a->misses += 100;
+    b->misses += 1;
+    m.tune_ratios(0.1, 4);
+  }
+  ASSERT_GT(a->get_cache_ratio(), 0.25);
+  ASSERT_LT(b->get_cache_ratio(), 0.25);
+  ASSERT_NEAR(1.0, a->get_cache_ratio() + b->get_cache_ratio() +
+              c->get_cache_ratio(), 1e-9);
+
+  // no traffic at all: nothing moves
+  double ra = a->get_cache_ratio();
+  a->set_cache_ratio(0.25);
+  b->set_cache_ratio(0.25);
+  c->set_cache_ratio(0.5);
+  m.tune_ratios(0.1, 4);
+  ASSERT_NEAR(ra, a->get_cache_ratio(), 1e-9);
+}
+
+TEST(PriorityCache, DumpRatioTuner)
+{
+  Manager m(g_ceph_context, 1 << 30, 1 << 30, 1 << 30, false,
+            "test-pricache-dump");
+  auto a = std::make_shared<FakeCache>(0.5);
+  auto b = std::make_shared<FakeCache>(0.5);
+  m.insert("a", a, false);
+  m.insert("b", b, false);
+  m.tune_ratios(0.1, 4);
+  m.tune_ratios(0.1, 4);
+
+  JSONFormatter f;
+  m.dump_ratio_tuner(&f);
+  std::ostringstream os;
+  f.flush(os);
+  ASSERT_NE(std::string::npos, os.str().find("\"rounds\":2"));
+  ASSERT_NE(std::string::npos, os.str().find("\"name\":\"b\""));
+
+  // an erased cache drops out of the dump without waiting for another round
+  m.erase("b");
+  JSONFormatter f2;
+  m.dump_ratio_tuner(&f2);
+  std::ostringstream os2;
+  f2.flush(os2);
+  ASSERT_EQ(std::string::npos, os2.str().find("\"name\":\"b\""));
+  ASSERT_NE(std::string::npos, os2.str().find("\"name\":\"a\""));
+}
@@ -233,3 +233,58 @@ TEST_F(TestSimplePolicy, test_evict_list_10) {
     m_promoted_lru.erase(m_promoted_lru.begin());
   }
 }
+
+TEST_F(TestSimplePolicy, test_admission_hits) {
+  SimplePolicy policy(g_ceph_context, m_cache_size, 128, 0.9, 2, 2);
+
+  // first lookup is only remembered
+  ASSERT_EQ(OBJ_CACHE_SKIP, policy.lookup_object("admission_file_1"));
+  ASSERT_EQ(OBJ_CACHE_NONE, policy.get_status("admission_file_1"));
+  ASSERT_EQ(1U, policy.get_history_entry_num());
+
+  // second lookup promotes it
+  ASSERT_EQ(OBJ_CACHE_NONE, policy.lookup_object("admission_file_1"));
+  ASSERT_EQ(OBJ_CACHE_SKIP, policy.get_status("admission_file_1"));
+  ASSERT_EQ(0U, policy.get_history_entry_num());
+  policy.update_status("admission_file_1", OBJ_CACHE_PROMOTED, 1);
+
+  // the history is bounded
+  ASSERT_EQ(OBJ_CACHE_SKIP, policy.lookup_object("admission_file_2"));
+  ASSERT_EQ(OBJ_CACHE_SKIP, policy.lookup_object("admission_file_3"));
+  ASSERT_EQ(OBJ_CACHE_SKIP, policy.lookup_object("admission_file_4"));
+  ASSERT_EQ(2U, policy.get_history_entry_num());
+  ASSERT_EQ(OBJ_CACHE_SKIP, policy.lookup_object("admission_file_2"));
+
+  // an evicted object comes back on its next lookup
+  policy.evict_entry("admission_file_1");
+  ASSERT_EQ(OBJ_CACHE_NONE, policy.get_status("admission_file_1"));
+  ASSERT_EQ(OBJ_CACHE_NONE, policy.lookup_object("admission_file_1"));
+  policy.update_status("admission_file_1", OBJ_CACHE_PROMOTED, 1);
+  policy.evict_entry("admission_file_1");
+}
+
+TEST_F(TestSimplePolicy, test_promoted_entries) {
+  std::list<policy_entry_t> entries;
+  m_simple_policy->get_promoted_entries(&entries);
+  ASSERT_EQ(m_promoted_lru.size(), entries.size());
+  auto it = m_promoted_lru.begin();
+  for (auto& entry : entries) {
+    ASSERT_EQ(*it++, entry.file_name);
+    ASSERT_EQ(OBJ_CACHE_PROMOTED, entry.status);
+    ASSERT_EQ(1U, entry.size);
+  }
+  // walking the entries must not reorder the LRU
+  ASSERT_EQ(m_promoted_lru.front(), m_simple_policy->get_evict_entry());
+
+  SimplePolicy policy(g_ceph_context, m_cache_size, 128, 0.9);
+  for (auto& entry : entries) {
+    ASSERT_EQ(0, policy.load_promoted_entry(entry));
+  }
+  ASSERT_EQ(-EEXIST, policy.load_promoted_entry(entries.front()));
+  ASSERT_EQ(-EINVAL, policy.load_promoted_entry(
+    {"promoting_file", OBJ_CACHE_SKIP, 1}));
+  ASSERT_EQ(m_simple_policy->get_free_size(), policy.get_free_size());
+  ASSERT_EQ(entries.size(), policy.get_promoted_entry_num());
+  ASSERT_EQ(entries.front().file_name, policy.get_evict_entry());
+  ASSERT_EQ(OBJ_CACHE_PROMOTED, policy.lookup_object(entries.back().file_name));
+}
@@ -113,6 +113,33 @@ TEST_F(TestMockCryptoBlockCrypto, Encrypt) {
   ASSERT_EQ(data.length(), 8192);
 }
 
+TEST_F(TestMockCryptoBlockCrypto, DecryptInPlace) {
+  uint32_t image_offset = 0x1230 * 512;
+
+  ceph::bufferlist data;
+  data.append(std::string(4096, '1') + std::string(4096, '2'));
+  auto buf = data.c_str();
+
+  expect_get_context(CipherMode::CIPHER_MODE_DEC);
+  expect_init_context(std::string("\x30\x12\0\0\0\0\0\0\0\0\0\0\0\0\0\0", 16));
+  _set_last_expectation(
+          EXPECT_CALL(*cryptor, update_context(_, (const unsigned char*)buf,
+                                              (unsigned char*)buf, 4096))
+          .After(*expectation_set).WillOnce(Return(4096)));
+  expect_init_context(std::string("\x38\x12\0\0\0\0\0\0\0\0\0\0\0\0\0\0", 16));
+  _set_last_expectation(
+          EXPECT_CALL(*cryptor, update_context(
+                  _, (const unsigned char*)buf + 4096,
+                  (unsigned char*)buf + 4096, 4096))
+          .After(*expectation_set).WillOnce(Return(4096)));
+  expect_return_context(CipherMode::CIPHER_MODE_DEC);
+
+  ASSERT_EQ(0, bc->decrypt(&data, image_offset));
+
+  ASSERT_EQ(data.length(), 8192);
+  ASSERT_EQ(data.c_str(), buf);
+}
+
 TEST_F(TestMockCryptoBlockCrypto, UnalignedImageOffset) {
   ceph::bufferlist data;
   data.append(std::string(4096, '1'));
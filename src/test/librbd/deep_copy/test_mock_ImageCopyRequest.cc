@@ -546,6 +546,54 @@ TEST_F(TestMockDeepCopyImageCopyRequest, OutOfOrder) {
   ASSERT_EQ(0, ctx.wait());
 }
 
+TEST_F(TestMockDeepCopyImageCopyRequest, HandlerMaxConcurrentOps) {
+  librados::snap_t snap_id_end;
+  ASSERT_EQ(0, create_snap("copy", &snap_id_end));
+
+  uint64_t object_count = 4;
+
+  librbd::MockTestImageCtx mock_src_image_ctx(*m_src_image_ctx);
+  librbd::MockTestImageCtx mock_dst_image_ctx(*m_dst_image_ctx);
+  MockObjectCopyRequest mock_object_copy_request;
+
+  MockDiffRequest mock_diff_request;
+  expect_diff_send(mock_diff_request, {}, -EINVAL);
+  expect_get_image_size(mock_src_image_ctx,
+                        object_count * (1 << m_src_image_ctx->order));
+  expect_get_image_size(mock_src_image_ctx, 0);
+
+  EXPECT_CALL(mock_object_copy_request, send()).Times(object_count);
+
+  struct Handler : public librbd::deep_copy::NoOpHandler {
+    uint64_t get_max_concurrent_ops() override {
+      return 2;
+    }
+  } handler;
+
+  C_SaferCond ctx;
+  auto request = new MockImageCopyRequest(&mock_src_image_ctx,
+                                          &mock_dst_image_ctx,
+                                          0, snap_id_end, 0, false, boost::none,
+                                          m_snap_seqs, &handler, &ctx);
+  request->send();
+
+  ASSERT_EQ(m_snap_map, wait_for_snap_map(mock_object_copy_request));
+  Context *copy_ctx0;
+  Context *copy_ctx1;
+  ASSERT_TRUE(complete_object_copy(mock_object_copy_request, 0, &copy_ctx0, 0));
+  ASSERT_TRUE(complete_object_copy(mock_object_copy_request, 1, &copy_ctx1, 0));
+  {
+    std::lock_guard locker{mock_object_copy_request.lock};
+    ASSERT_EQ(2U, mock_object_copy_request.object_contexts.size());
+  }
+
+  copy_ctx0->complete(0);
+  copy_ctx1->complete(0);
+  ASSERT_TRUE(complete_object_copy(mock_object_copy_request, 2, nullptr, 0));
+  ASSERT_TRUE(complete_object_copy(mock_object_copy_request, 3, nullptr, 0));
+  ASSERT_EQ(0, ctx.wait());
+}
+
 TEST_F(TestMockDeepCopyImageCopyRequest, SnapshotSubset) {
   librados::snap_t snap_id_start;
   librados::snap_t snap_id_end;
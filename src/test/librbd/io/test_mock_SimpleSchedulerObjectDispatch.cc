@@ -11,6 +11,8 @@
 #include "librbd/io/ObjectDispatchSpec.h"
 #include "librbd/io/SimpleSchedulerObjectDispatch.h"
 
+#include <thread>
+
 namespace librbd {
 namespace {
 
@@ -819,5 +821,66 @@ TEST_F(TestMockIoSimpleSchedulerObjectDispatch, Timer) {
   ASSERT_EQ(0, cond2.wait());
 }
 
+TEST_F(TestMockIoSimpleSchedulerObjectDispatch, AdaptiveDelayOverdue) {
+  EXPECT_EQ(0, _rados.conf_set("rbd_io_scheduler_simple_max_delay", "0"));
+
+  librbd::ImageCtx *ictx;
+  ASSERT_EQ(0, open_image(m_image_name, &ictx));
+
+  MockTestImageCtx mock_image_ctx(*ictx);
+  MockSimpleSchedulerObjectDispatch
+      mock_simple_scheduler_object_dispatch(&mock_image_ctx);
+
+  for (uint64_t object_no = 0; object_no <= LATENCY_STATS_WINDOW_SIZE;
+       object_no++) {
+    expect_get_object_name(mock_image_ctx, object_no);
+  }
+
+  // collect latency stats from writes that complete right away
+  int object_dispatch_flags = 0;
+  for (uint64_t object_no = 1; object_no <= LATENCY_STATS_WINDOW_SIZE;
+       object_no++) {
+    ceph::bufferlist data;
+    data.append("X");
+    C_SaferCond cond;
+    Context *on_finish = &cond;
+    ASSERT_FALSE(mock_simple_scheduler_object_dispatch.write(
+        object_no, 0, std::move(data), mock_image_ctx.get_data_io_context(),
+        0, 0, std::nullopt, {}, &object_dispatch_flags, nullptr, nullptr,
+        &on_finish, nullptr));
+    on_finish->complete(0);
+    ASSERT_EQ(0, cond.wait());
+  }
+
+  ceph::bufferlist data;
+  data.append("X");
+  C_SaferCond cond1;
+  Context *on_finish1 = &cond1;
+  ASSERT_FALSE(mock_simple_scheduler_object_dispatch.write(
+      0, 0, std::move(data), mock_image_ctx.get_data_io_context(), 0, 0,
+      std::nullopt, {}, &object_dispatch_flags, nullptr, nullptr, &on_finish1,
+      nullptr));
+  ASSERT_NE(on_finish1, &cond1);
+
+  // the in-flight write is now well past the observed latency, so the
+  // next write is not held back behind it
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  data.clear();
+  data.append("X");
+  C_SaferCond cond2;
+  Context *on_finish2 = &cond2;
+  ASSERT_FALSE(mock_simple_scheduler_object_dispatch.write(
+      0, 1, std::move(data), mock_image_ctx.get_data_io_context(), 0, 0,
+      std::nullopt, {}, &object_dispatch_flags, nullptr, nullptr, &on_finish2,
+      nullptr));
+  ASSERT_NE(on_finish2, &cond2);
+
+  on_finish1->complete(0);
+  ASSERT_EQ(0, cond1.wait());
+  on_finish2->complete(0);
+  ASSERT_EQ(0, cond2.wait());
+}
+
 } // namespace io
 } // namespace librbd
@@ -845,6 +845,50 @@ TEST_F(TestMockMigrationQCOWFormat, Read) {
   ASSERT_EQ(0, ctx3.wait());
 }
 
+TEST_F(TestMockMigrationQCOWFormat, ReadCoalescedClusters) {
+  MockTestImageCtx mock_image_ctx(*m_image_ctx);
+
+  InSequence seq;
+  MockSourceSpecBuilder mock_source_spec_builder;
+
+  auto mock_stream_interface = new MockStreamInterface();
+  expect_build_stream(mock_source_spec_builder, mock_stream_interface, 0);
+
+  expect_open(*mock_stream_interface, {{1ULL<<40}});
+
+  expect_read_l2_table(*mock_stream_interface, 1ULL<<40,
+                       {{0, 1ULL<<32, (1ULL<<32) + (1<<16)}}, 0);
+
+  bufferlist expect_bl;
+  expect_bl.append(std::string(1<<16, '1'));
+  expect_stream_read(*mock_stream_interface, {{(1ULL<<32) + 100, 1<<16}},
+                     expect_bl, 0);
+
+  expect_stream_close(*mock_stream_interface, 0);
+
+  MockQCOWFormat mock_qcow_format(&mock_image_ctx, json_object,
+                                  &mock_source_spec_builder);
+
+  C_SaferCond ctx1;
+  mock_qcow_format.open(&ctx1);
+  ASSERT_EQ(0, ctx1.wait());
+
+  C_SaferCond ctx2;
+  auto aio_comp = io::AioCompletion::create_and_start(
+    &ctx2, m_image_ctx, io::AIO_TYPE_READ);
+  bufferlist bl;
+  io::ReadResult read_result{&bl};
+  ASSERT_TRUE(mock_qcow_format.read(aio_comp, CEPH_NOSNAP,
+                                    {{(1<<16) + 100, 1<<16}},
+                                    std::move(read_result), 0, 0, {}));
+  ASSERT_EQ(1<<16, ctx2.wait());
+  ASSERT_EQ(expect_bl, bl);
+
+  C_SaferCond ctx3;
+  mock_qcow_format.close(&ctx3);
+  ASSERT_EQ(0, ctx3.wait());
+}
+
 TEST_F(TestMockMigrationQCOWFormat, ReadL1DNE) {
   MockTestImageCtx mock_image_ctx(*m_image_ctx);
 
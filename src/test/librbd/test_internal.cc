@@ -1225,6 +1225,74 @@ TEST_F(TestInternal, DiffIterateCloneOverwrite) {
   ASSERT_EQ(one, diff);
 }
 
+TEST_F(TestInternal, DiffIterateFastDiffStriping) {
+  REQUIRE_FEATURE(RBD_FEATURE_FAST_DIFF | RBD_FEATURE_STRIPINGV2);
+
+  uint64_t features;
+  ASSERT_TRUE(::get_features(&features));
+
+  // 64K objects, 16K stripe units over 4 objects: each 256K period is one
+  // object set, and an object covers one stripe unit in each 64K row
+  librbd::RBD rbd;
+  librbd::Image image;
+  std::string name = get_temp_image_name();
+  uint64_t size = 1 << 20;
+  uint64_t object_size = 64 << 10;
+  uint64_t stripe_unit = 16 << 10;
+  uint64_t stripe_count = 4;
+  int order = 16;
+  ASSERT_EQ(0, rbd.create3(m_ioctx, name.c_str(), size, features, &order,
+                           stripe_unit, stripe_count));
+  ASSERT_EQ(0, rbd.open(m_ioctx, image, name.c_str(), NULL));
+
+  auto object_extents = [&](uint64_t object_no) {
+    uint64_t period = object_size * stripe_count;
+    uint64_t period_off = (object_no / stripe_count) * period;
+    uint64_t su_off = (object_no % stripe_count) * stripe_unit;
+    interval_set<uint64_t> extents;
+    for (uint64_t row = 0; row < period; row += stripe_unit * stripe_count) {
+      extents.insert(period_off + row + su_off, stripe_unit);
+    }
+    return extents;
+  };
+
+  bufferlist bl;
+  bl.append(std::string(4096, '1'));
+  // object 0 in the first period and object 9 in the third, the second and
+  // the fourth period are clean
+  ASSERT_EQ(4096, image.write(0, bl.length(), bl));
+  ASSERT_EQ(4096, image.write((2 << 18) + (16 << 10), bl.length(), bl));
+
+  interval_set<uint64_t> expected;
+  expected.union_of(object_extents(0));
+  expected.union_of(object_extents(9));
+
+  interval_set<uint64_t> diff;
+  ASSERT_EQ(0, image.diff_iterate2(NULL, 0, size, true, true, iterate_cb,
+                                   (void *)&diff));
+  ASSERT_EQ(expected, diff);
+
+  ASSERT_EQ(0, image.snap_create("one"));
+
+  // only object 15 of the last period changes after the snapshot
+  ASSERT_EQ(4096, image.write((3 << 18) + (48 << 10), bl.length(), bl));
+
+  diff.clear();
+  ASSERT_EQ(0, image.diff_iterate2("one", 0, size, true, true, iterate_cb,
+                                   (void *)&diff));
+  ASSERT_EQ(object_extents(15), diff);
+
+  // a range that starts and ends inside partially dirty periods
+  diff.clear();
+  ASSERT_EQ(0, image.diff_iterate2(NULL, 8 << 10, (3 << 18) + (56 << 10),
+                                   true, true, iterate_cb, (void *)&diff));
+  expected.union_of(object_extents(15));
+  interval_set<uint64_t> range;
+  range.insert(8 << 10, (3 << 18) + (56 << 10));
+  expected.intersection_of(range);
+  ASSERT_EQ(expected, diff);
+}
+
 TEST_F(TestInternal, TestCoR)
 {
   REQUIRE_FEATURE(RBD_FEATURE_LAYERING);
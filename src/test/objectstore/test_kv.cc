@@ -495,6 +495,214 @@ TEST_P(KVTest, RocksDBShardingIteratorTest) {
   fini();
 }
 
+TEST_P(KVTest, IteratorViewsAndNextN) {
+  if(string(GetParam()) != "rocksdb")
+    return;
+
+  // default cf, single cf and sharded cf take different iterator paths
+  std::string cfs("B A(4)");
+  ASSERT_EQ(0, db->init(g_conf()->bluestore_rocksdb_options));
+  ASSERT_EQ(0, db->create_and_open(cout, cfs));
+  {
+    KeyValueDB::Transaction t = db->get_transaction();
+    for (int v = 100; v <= 999; v++) {
+      std::string str = to_string(v);
+      bufferlist val;
+      val.append("v" + str);
+      t->set("A", str, val);
+      t->set("B", str, val);
+      t->set("prefix", str, val);
+    }
+    ASSERT_EQ(0, db->submit_transaction_sync(t));
+  }
+  for (auto prefix : {"A", "B", "prefix"}) {
+    cout << "checking " << prefix << std::endl;
+    KeyValueDB::Iterator it = db->get_iterator(prefix);
+    ASSERT_EQ(0, it->seek_to_first());
+    ASSERT_TRUE(it->valid());
+    ASSERT_EQ("100", it->key_as_sv());
+    ASSERT_EQ("v100", it->value_as_sv());
+
+    int pos = 100;
+    size_t n;
+    do {
+      n = it->next_n(64, [&](std::string_view k, std::string_view v) {
+	EXPECT_EQ(to_string(pos), k);
+	EXPECT_EQ("v" + to_string(pos), v);
+	++pos;
+	return true;
+      });
+    } while (n == 64);
+    ASSERT_EQ(1000, pos);
+    ASSERT_FALSE(it->valid());
+
+    // the visitor can stop the walk without consuming the entry
+    ASSERT_EQ(0, it->lower_bound("500"));
+    n = it->next_n(1000, [](std::string_view k, std::string_view v) {
+      return k < "510";
+    });
+    ASSERT_EQ(10u, n);
+    ASSERT_TRUE(it->valid());
+    ASSERT_EQ("510", it->key());
+  }
+  fini();
+}
+
+TEST_P(KVTest, BenchIterate) {
+  if(string(GetParam()) != "rocksdb")
+    return;
+
+  const int n = 200000;
+  ASSERT_EQ(0, db->init(g_conf()->bluestore_rocksdb_options));
+  ASSERT_EQ(0, db->create_and_open(cout));
+  {
+    bufferlist val;
+    val.append(std::string(100, 'x'));
+    KeyValueDB::Transaction t = db->get_transaction();
+    for (int i = 0; i < n; ++i) {
+      char key[16];
+      snprintf(key, sizeof(key), "%010d", i);
+      t->set("prefix", key, val);
+    }
+    ASSERT_EQ(0, db->submit_transaction_sync(t));
+  }
+  db->compact();
+
+  uint64_t bytes = 0;
+  utime_t start = ceph_clock_now();
+  {
+    auto it = db->get_iterator("prefix", KeyValueDB::ITERATOR_SCAN);
+    for (it->seek_to_first(); it->valid(); it->next()) {
+      bytes += it->key().size() + it->value().length();
+    }
+  }
+  utime_t copy_dur = ceph_clock_now() - start;
+
+  uint64_t sv_bytes = 0;
+  start = ceph_clock_now();
+  {
+    auto it = db->get_iterator("prefix", KeyValueDB::ITERATOR_SCAN);
+    it->seek_to_first();
+    while (it->next_n(1024, [&](std::string_view k, std::string_view v) {
+	     sv_bytes += k.size() + v.size();
+	     return true;
+	   })) ;
+  }
+  utime_t sv_dur = ceph_clock_now() - start;
+
+  ASSERT_EQ(bytes, sv_bytes);
+  cout << n << " entries: key()/value() " << copy_dur
+       << ", next_n() " << sv_dur << std::endl;
+  fini();
+}
+
+TEST_P(KVTest, SetRmKeysRun) {
+  if(string(GetParam()) != "rocksdb")
+    return;
+
+  // O is sharded within the key base, so the CF is resolved once per run;
+  // P is sharded on the whole key, so it has to be looked up per key.
+  std::string cfs("O(3,0-4) P(3)");
+  ASSERT_EQ(0, db->create_and_open(cout, cfs));
+  const string base("base.");
+  const int n = 100;
+  for (auto prefix : {"O", "P", "plain"}) {
+    {
+      bufferlist bl;
+      encode((uint32_t)n, bl);
+      for (int i = 0; i < n; ++i) {
+	encode("key" + stringify(i), bl);
+	bufferlist value;
+	value.append("value" + stringify(i));
+	encode(value, bl);
+      }
+      KeyValueDB::Transaction t = db->get_transaction();
+      auto p = bl.cbegin();
+      ASSERT_EQ((uint32_t)n, t->set_run(prefix, base, p));
+      ASSERT_TRUE(p.end());
+      ASSERT_EQ(0, db->submit_transaction_sync(t));
+    }
+    for (int i = 0; i < n; ++i) {
+      bufferlist value;
+      ASSERT_EQ(0, db->get(prefix, base + "key" + stringify(i), &value));
+      ASSERT_EQ("value" + stringify(i), _bl_to_str(value));
+    }
+    {
+      bufferlist bl;
+      encode((uint32_t)(n / 2), bl);
+      for (int i = 0; i < n; i += 2) {
+	encode("key" + stringify(i), bl);
+      }
+      KeyValueDB::Transaction t = db->get_transaction();
+      auto p = bl.cbegin();
+      ASSERT_EQ((uint32_t)(n / 2), t->rmkeys_run(prefix, base, p));
+      ASSERT_EQ(0, db->submit_transaction_sync(t));
+    }
+    for (int i = 0; i < n; ++i) {
+      bufferlist value;
+      ASSERT_EQ(i % 2 ? 0 : -ENOENT,
+		db->get(prefix, base + "key" + stringify(i), &value));
+    }
+  }
+  fini();
+}
+
+TEST_P(KVTest, BenchOmapInsert) {
+  if(string(GetParam()) != "rocksdb")
+    return;
+
+  const int n = 100000;
+  std::string cfs("p(3,0-12)");
+  ASSERT_EQ(0, db->init(g_conf()->bluestore_rocksdb_options));
+  ASSERT_EQ(0, db->create_and_open(cout, cfs));
+  // same shape as a BlueStore omap run: 17 byte object key base + omap key
+  const string base(16, '\1');
+  bufferlist bl;
+  encode((uint32_t)n, bl);
+  for (int i = 0; i < n; ++i) {
+    char key[32];
+    snprintf(key, sizeof(key), ".%020d", i);
+    encode(string(key), bl);
+    bufferlist value;
+    value.append(std::string(64, 'x'));
+    encode(value, bl);
+  }
+
+  utime_t start = ceph_clock_now();
+  {
+    KeyValueDB::Transaction t = db->get_transaction();
+    auto p = bl.cbegin();
+    uint32_t num;
+    decode(num, p);
+    string final_key = base;
+    while (num--) {
+      string key;
+      bufferlist value;
+      decode(key, p);
+      decode(value, p);
+      final_key.resize(base.size());
+      final_key += key;
+      t->set("p", final_key, value);
+    }
+    ASSERT_EQ(0, db->submit_transaction_sync(t));
+  }
+  utime_t per_key_dur = ceph_clock_now() - start;
+
+  start = ceph_clock_now();
+  {
+    KeyValueDB::Transaction t = db->get_transaction();
+    auto p = bl.cbegin();
+    ASSERT_EQ((uint32_t)n, t->set_run("p", base, p));
+    ASSERT_EQ(0, db->submit_transaction_sync(t));
+  }
+  utime_t run_dur = ceph_clock_now() - start;
+
+  cout << n << " omap keys: per-key set() " << per_key_dur
+       << " (" << n / (double)per_key_dur << " keys/s), set_run() " << run_dur
+       << " (" << n / (double)run_dur << " keys/s)" << std::endl;
+  fini();
+}
+
 TEST_P(KVTest, RocksDBCFMerge) {
   if(string(GetParam()) != "rocksdb")
     return;
@@ -0,0 +1,100 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+/*
+ * Multithreaded micro-benchmark of the Objecter's pg mapping cache: every
+ * thread performs the lookup that _calc_target() does for each submitted op,
+ * and refreshes the entry on a miss, while one thread periodically bumps the
+ * epoch as if a new osdmap had arrived.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "osdc/PGMappingCache.h"
+
+using namespace std;
+
+static void usage(const char *name) {
+  cout << name << " <threads> <ops per thread> [pg_num] [epoch interval]\n"
+       << "\t threads: the number of submitting threads.\n"
+       << "\t ops per thread: lookups performed by each thread.\n"
+       << "\t pg_num: pgs in the simulated pool (default 1024).\n"
+       << "\t epoch interval: lookups between osdmap epochs, 0 to disable "
+       << "(default 100000).\n";
+}
+
+static double run(unsigned shards, unsigned threads, uint64_t ops,
+		  unsigned pg_num, uint64_t epoch_interval)
+{
+  PGMappingCache cache(shards);
+  mempool::osdmap::map<int64_t,pg_pool_t> pools;
+  pools[1].set_pg_num(pg_num);
+  cache.prune(pools);
+
+  std::atomic<epoch_t> epoch{1};
+  std::atomic<uint64_t> misses{0};
+  auto start = std::chrono::steady_clock::now();
+  vector<std::thread> workers;
+  for (unsigned t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      vector<int> up, acting;
+      int up_primary, acting_primary;
+      uint64_t seed = t * 2654435761u + 1;
+      uint64_t my_misses = 0;
+      for (uint64_t i = 0; i < ops; ++i) {
+	if (t == 0 && epoch_interval && i && i % epoch_interval == 0) {
+	  ++epoch;
+	}
+	seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+	pg_t pg((seed >> 33) % pg_num, 1);
+	epoch_t e = epoch.load(std::memory_order_relaxed);
+	if (!cache.lookup(pg, e, &up, &up_primary, &acting, &acting_primary)) {
+	  ++my_misses;
+	  int osd = pg.ps() % 64;
+	  cache.update(pg, PGMappingCache::pg_mapping_t(
+			     e, {osd, osd + 1, osd + 2}, osd,
+			     {osd, osd + 1, osd + 2}, osd));
+	}
+      }
+      misses += my_misses;
+    });
+  }
+  for (auto& w : workers) {
+    w.join();
+  }
+  std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+  double rate = threads * ops / elapsed.count();
+  cout << "shards " << shards
+       << " threads " << threads
+       << " elapsed " << elapsed.count() << "s"
+       << " lookups/s " << (uint64_t)rate
+       << " misses " << misses << std::endl;
+  return rate;
+}
+
+int main(int argc, const char **argv)
+{
+  if (argc < 3) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  unsigned threads = atoi(argv[1]);
+  uint64_t ops = strtoull(argv[2], nullptr, 10);
+  unsigned pg_num = argc > 3 ? atoi(argv[3]) : 1024;
+  uint64_t epoch_interval = argc > 4 ? strtoull(argv[4], nullptr, 10) : 100000;
+  if (!threads || !pg_num) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  for (unsigned shards : {1, 4, 16, 64}) {
+    run(shards, threads, ops, pg_num, epoch_interval);
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,132 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "osdc/PGMappingCache.h"
+
+namespace {
+
+mempool::osdmap::map<int64_t,pg_pool_t> make_pools(
+  std::initializer_list<std::pair<int64_t, unsigned>> pg_nums)
+{
+  mempool::osdmap::map<int64_t,pg_pool_t> pools;
+  for (auto& [id, pg_num] : pg_nums) {
+    pg_pool_t p;
+    p.set_pg_num(pg_num);
+    pools[id] = p;
+  }
+  return pools;
+}
+
+void check_lookup(const PGMappingCache& cache, const pg_t& pg, epoch_t e,
+                  bool expect_hit)
+{
+  std::vector<int> up, acting;
+  int up_primary = -1, acting_primary = -1;
+  bool hit = cache.lookup(pg, e, &up, &up_primary, &acting, &acting_primary);
+  ASSERT_EQ(expect_hit, hit);
+  if (hit) {
+    ASSERT_EQ(std::vector<int>({(int)pg.ps(), 1}), up);
+    ASSERT_EQ((int)pg.ps(), up_primary);
+    ASSERT_EQ(std::vector<int>({(int)pg.ps(), 2}), acting);
+    ASSERT_EQ((int)pg.ps(), acting_primary);
+  }
+}
+
+void fill(PGMappingCache& cache, int64_t pool, unsigned pg_num, epoch_t e)
+{
+  for (unsigned ps = 0; ps < pg_num; ++ps) {
+    cache.update(pg_t(ps, pool),
+                 PGMappingCache::pg_mapping_t(e, {(int)ps, 1}, ps,
+                                              {(int)ps, 2}, ps));
+  }
+}
+
+} // anonymous namespace
+
+class PGMappingCacheTest : public ::testing::TestWithParam<unsigned> {};
+
+TEST_P(PGMappingCacheTest, LookupUpdate)
+{
+  PGMappingCache cache(GetParam());
+  // 7 is not a multiple of any shard count we test
+  cache.prune(make_pools({{1, 7}, {2, 64}}));
+  for (unsigned ps = 0; ps < 7; ++ps) {
+    check_lookup(cache, pg_t(ps, 1), 10, false);
+  }
+  fill(cache, 1, 7, 10);
+  fill(cache, 2, 64, 10);
+  for (unsigned ps = 0; ps < 7; ++ps) {
+    check_lookup(cache, pg_t(ps, 1), 10, true);
+    // stale epoch
+    check_lookup(cache, pg_t(ps, 1), 11, false);
+  }
+  for (unsigned ps = 0; ps < 64; ++ps) {
+    check_lookup(cache, pg_t(ps, 2), 10, true);
+  }
+  // unknown pool
+  check_lookup(cache, pg_t(0, 3), 10, false);
+}
+
+TEST_P(PGMappingCacheTest, Prune)
+{
+  PGMappingCache cache(GetParam());
+  cache.prune(make_pools({{1, 8}, {2, 8}}));
+  fill(cache, 1, 8, 5);
+  fill(cache, 2, 8, 5);
+
+  // pool 2 deleted, pool 1 split
+  cache.prune(make_pools({{1, 32}}));
+  for (unsigned ps = 0; ps < 8; ++ps) {
+    check_lookup(cache, pg_t(ps, 2), 5, false);
+  }
+  fill(cache, 1, 32, 6);
+  for (unsigned ps = 0; ps < 32; ++ps) {
+    check_lookup(cache, pg_t(ps, 1), 6, true);
+  }
+
+  // pool 1 merged back
+  cache.prune(make_pools({{1, 3}}));
+  for (unsigned ps = 0; ps < 3; ++ps) {
+    check_lookup(cache, pg_t(ps, 1), 6, true);
+  }
+  for (unsigned ps = 3; ps < 32; ++ps) {
+    check_lookup(cache, pg_t(ps, 1), 6, false);
+  }
+}
+
+TEST_P(PGMappingCacheTest, Concurrent)
+{
+  constexpr unsigned pg_num = 256;
+  constexpr unsigned num_threads = 8;
+  PGMappingCache cache(GetParam());
+  cache.prune(make_pools({{1, pg_num}}));
+
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&cache, t] {
+      for (epoch_t e = 1; e <= 50; ++e) {
+        for (unsigned ps = t; ps < pg_num; ps += num_threads) {
+          pg_t pg(ps, 1);
+          cache.update(pg, PGMappingCache::pg_mapping_t(
+                             e, {(int)ps, 1}, ps, {(int)ps, 2}, ps));
+          check_lookup(cache, pg, e, true);
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  for (unsigned ps = 0; ps < pg_num; ++ps) {
+    check_lookup(cache, pg_t(ps, 1), 50, true);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+  PGMappingCache,
+  PGMappingCacheTest,
+  ::testing::Values(1, 2, 5, 16));
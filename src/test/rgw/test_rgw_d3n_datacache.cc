@@ -0,0 +1,171 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab ft=cpp
+
+/*
+ * Ceph - scalable distributed file system
+ *
+ * This is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License version 2.1, as published by the Free Software
+ * Foundation.  See file COPYING.
+ */
+
+#include "rgw/rgw_d3n_datacache.h"
+#include "global/global_context.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+using namespace std::chrono_literals;
+
+TEST(D3nFrequencySketch, Increment)
+{
+  D3nFrequencySketch sketch;
+  sketch.init(1024);
+  EXPECT_EQ(1u, sketch.increment("a"));
+  EXPECT_EQ(2u, sketch.increment("a"));
+  EXPECT_EQ(3u, sketch.increment("a"));
+  EXPECT_EQ(1u, sketch.increment("b"));
+}
+
+TEST(D3nFrequencySketch, MinWidth)
+{
+  D3nFrequencySketch sketch;
+  sketch.init(0);
+  EXPECT_EQ(1u, sketch.increment("a"));
+  EXPECT_EQ(2u, sketch.increment("a"));
+}
+
+TEST(D3nFrequencySketch, Saturate)
+{
+  D3nFrequencySketch sketch;
+  sketch.init(1024);
+  unsigned estimate = 0;
+  for (int i = 0; i < 100; i++) {
+    estimate = sketch.increment("a");
+  }
+  EXPECT_EQ(15u, estimate);
+}
+
+TEST(D3nFrequencySketch, Age)
+{
+  // counters are halved after 10 increments per column
+  D3nFrequencySketch sketch;
+  sketch.init(64);
+  for (int i = 0; i < 15; i++) {
+    sketch.increment("a");
+  }
+  for (int i = 15; i < 640 - 1; i++) {
+    sketch.increment("b");
+  }
+  EXPECT_EQ(15u, sketch.increment("b"));
+
+  // 15 halved to 7, plus this increment
+  EXPECT_EQ(8u, sketch.increment("b"));
+  EXPECT_GE(8u, sketch.increment("a"));
+}
+
+class D3nLoadCache : public ::testing::Test {
+protected:
+  fs::path dir;
+
+  void SetUp() override {
+    dir = fs::temp_directory_path() /
+          ("unittest_rgw_d3n." + std::to_string(::getpid()));
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    auto& conf = g_ceph_context->_conf;
+    conf.set_val_or_die("rgw_d3n_l1_datacache_persistent_path", dir.string());
+    conf.set_val_or_die("rgw_d3n_l1_evict_cache_on_start", "false");
+    conf.set_val_or_die("rgw_d3n_l1_admission_hits", "1");
+    conf.apply_changes(nullptr);
+  }
+
+  void TearDown() override {
+    fs::remove_all(dir);
+  }
+
+  void set_cache_size(uint64_t size) {
+    auto& conf = g_ceph_context->_conf;
+    conf.set_val_or_die("rgw_d3n_l1_datacache_size", std::to_string(size));
+    conf.apply_changes(nullptr);
+  }
+
+  // age orders the files from oldest to newest written
+  void write_file(const std::string& name, size_t size,
+                  fs::file_time_type::duration age = 0s) {
+    std::ofstream f(dir / name, std::ios::binary);
+    f << std::string(size, 'x');
+    f.close();
+    fs::last_write_time(dir / name, fs::file_time_type::clock::now() - age);
+  }
+};
+
+TEST_F(D3nLoadCache, Load)
+{
+  set_cache_size(1 << 20);
+  write_file("a", 100);
+  write_file("b", 200);
+  write_file("c.d3n_tmp", 100);
+  write_file("d", 0);
+  fs::create_directory(dir / "sub");
+
+  {
+    D3nDataCache cache;
+    cache.init(g_ceph_context);
+
+    // interrupted writes are cleaned up, everything else is indexed
+    EXPECT_TRUE(fs::exists(dir / "a"));
+    EXPECT_TRUE(fs::exists(dir / "b"));
+    EXPECT_FALSE(fs::exists(dir / "c.d3n_tmp"));
+    EXPECT_FALSE(fs::exists(dir / "d"));
+    EXPECT_TRUE(fs::exists(dir / "sub"));
+
+    EXPECT_TRUE(cache.get("a", 100));
+    EXPECT_TRUE(cache.get("b", 200));
+    EXPECT_FALSE(cache.get("c.d3n_tmp", 100));
+    EXPECT_FALSE(cache.get("d", 0));
+  }
+
+  // the files are kept for the next start
+  EXPECT_TRUE(fs::exists(dir / "a"));
+  EXPECT_TRUE(fs::exists(dir / "b"));
+}
+
+TEST_F(D3nLoadCache, Shrunk)
+{
+  set_cache_size(250);
+  write_file("old", 100, 3h);
+  write_file("mid", 100, 2h);
+  write_file("new", 100, 1h);
+
+  D3nDataCache cache;
+  cache.init(g_ceph_context);
+
+  // the oldest file no longer fits
+  EXPECT_FALSE(fs::exists(dir / "old"));
+  EXPECT_FALSE(cache.get("old", 100));
+
+  // the newest written is the most recently used
+  EXPECT_EQ(100u, cache.lru_eviction());
+  EXPECT_FALSE(fs::exists(dir / "mid"));
+  EXPECT_TRUE(fs::exists(dir / "new"));
+  EXPECT_TRUE(cache.get("new", 100));
+}
+
+TEST_F(D3nLoadCache, EvictOnStart)
+{
+  set_cache_size(1 << 20);
+  g_ceph_context->_conf.set_val_or_die("rgw_d3n_l1_evict_cache_on_start",
+                                       "true");
+  g_ceph_context->_conf.apply_changes(nullptr);
+  write_file("a", 100);
+
+  D3nDataCache cache;
+  cache.init(g_ceph_context);
+  EXPECT_FALSE(fs::exists(dir / "a"));
+  EXPECT_FALSE(cache.get("a", 100));
+}
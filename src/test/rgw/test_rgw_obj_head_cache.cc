@@ -0,0 +1,130 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab ft=cpp
+
+/*
+ * Ceph - scalable distributed file system
+ *
+ * This is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License version 2.1, as published by the Free Software
+ * Foundation.  See file COPYING.
+ */
+
+#include "rgw/rgw_obj_head_cache.h"
+#include <chrono>
+#include <thread>
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+static rgw_obj make_obj(const std::string& name)
+{
+  rgw_bucket bucket;
+  bucket.name = "bucket";
+  bucket.bucket_id = "id";
+  return rgw_obj(bucket, name);
+}
+
+static obj_head_entry make_head(uint64_t size)
+{
+  obj_head_entry head;
+  head.exists = true;
+  head.size = size;
+  head.attrset["user.rgw.etag"].append("etag");
+  return head;
+}
+
+TEST(ObjHeadCache, AddFind)
+{
+  RGWObjHeadCache cache(100, 1h);
+  const auto obj = make_obj("obj");
+
+  obj_head_entry found;
+  EXPECT_FALSE(cache.find(obj, found));
+
+  auto head = make_head(42);
+  cache.add(obj, cache.get_gen(obj), head);
+  ASSERT_TRUE(cache.find(obj, found));
+  EXPECT_TRUE(found.exists);
+  EXPECT_EQ(42u, found.size);
+  EXPECT_EQ(1u, found.attrset.count("user.rgw.etag"));
+
+  EXPECT_FALSE(cache.find(make_obj("other"), found));
+}
+
+TEST(ObjHeadCache, Negative)
+{
+  RGWObjHeadCache cache(100, 1h);
+  const auto obj = make_obj("missing");
+
+  obj_head_entry head;
+  cache.add(obj, cache.get_gen(obj), head);
+  obj_head_entry found;
+  ASSERT_TRUE(cache.find(obj, found));
+  EXPECT_FALSE(found.exists);
+}
+
+TEST(ObjHeadCache, Invalidate)
+{
+  RGWObjHeadCache cache(100, 1h);
+  const auto obj = make_obj("obj");
+
+  auto head = make_head(1);
+  cache.add(obj, cache.get_gen(obj), head);
+  cache.invalidate(obj);
+  obj_head_entry found;
+  EXPECT_FALSE(cache.find(obj, found));
+
+  // a read started after the invalidation may add the new head
+  head = make_head(2);
+  cache.add(obj, cache.get_gen(obj), head);
+  ASSERT_TRUE(cache.find(obj, found));
+  EXPECT_EQ(2u, found.size);
+}
+
+TEST(ObjHeadCache, InvalidateRacesWithRead)
+{
+  RGWObjHeadCache cache(100, 1h);
+  const auto obj = make_obj("obj");
+
+  // the read samples the generation, then a write invalidates the object
+  // before the read gets to add what it saw
+  const uint64_t gen = cache.get_gen(obj);
+  cache.invalidate(obj);
+  auto head = make_head(1);
+  cache.add(obj, gen, head);
+
+  obj_head_entry found;
+  EXPECT_FALSE(cache.find(obj, found));
+}
+
+TEST(ObjHeadCache, Expire)
+{
+  RGWObjHeadCache cache(100, 10ms);
+  const auto obj = make_obj("obj");
+
+  auto head = make_head(1);
+  cache.add(obj, cache.get_gen(obj), head);
+  obj_head_entry found;
+  EXPECT_TRUE(cache.find(obj, found));
+
+  std::this_thread::sleep_for(50ms);
+  EXPECT_FALSE(cache.find(obj, found));
+}
+
+TEST(ObjHeadCache, Cacheable)
+{
+  RGWBucketInfo info;
+  EXPECT_TRUE(RGWObjHeadCache::is_cacheable(info, make_obj("obj")));
+
+  auto obj = make_obj("obj");
+  obj.key.instance = "v1";
+  EXPECT_FALSE(RGWObjHeadCache::is_cacheable(info, obj));
+
+  obj = make_obj("obj");
+  obj.key.ns = "multipart";
+  EXPECT_FALSE(RGWObjHeadCache::is_cacheable(info, obj));
+
+  info.flags |= BUCKET_VERSIONED;
+  EXPECT_FALSE(RGWObjHeadCache::is_cacheable(info, make_obj("obj")));
+}
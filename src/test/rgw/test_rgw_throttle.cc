@@ -166,6 +166,45 @@ TEST_F(Aio_Throttle, ThrottleOverMax)
   EXPECT_EQ(window, max_outstanding);
 }
 
+TEST_F(Aio_Throttle, ThrottleGrowsToMaxWindow)
+{
+  constexpr uint64_t window = 4;
+  constexpr uint64_t max_window = 8;
+  BlockingAioThrottle throttle(window, max_window);
+
+  auto obj = make_obj(__PRETTY_FUNCTION__);
+
+  // issue 64 writes, and verify that the window grew but never past max
+  constexpr uint64_t total = 64;
+  uint64_t max_outstanding = 0;
+  uint64_t outstanding = 0;
+
+  // timer thread
+  boost::asio::io_context context;
+  using Executor = boost::asio::io_context::executor_type;
+  using Work = boost::asio::executor_work_guard<Executor>;
+  std::optional<Work> work(context.get_executor());
+  std::thread worker([&context] { context.run(); });
+  auto g = make_scope_guard([&work, &worker] {
+      work.reset();
+      worker.join();
+    });
+
+  for (uint64_t i = 0; i < total; i++) {
+    using namespace std::chrono_literals;
+    auto c = throttle.get(obj, wait_for(context, 10ms), 1, 0);
+    outstanding++;
+    outstanding -= c.size();
+    if (max_outstanding < outstanding) {
+      max_outstanding = outstanding;
+    }
+  }
+  auto c = throttle.drain();
+  outstanding -= c.size();
+  EXPECT_EQ(0u, outstanding);
+  EXPECT_EQ(max_window, max_outstanding);
+}
+
 TEST_F(Aio_Throttle, YieldCostOverWindow)
 {
   auto obj = make_obj(__PRETTY_FUNCTION__);
@@ -26,8 +26,8 @@ CacheController::~CacheController() {
 int CacheController::init() {
   ldout(m_cct, 20) << dendl;
   m_object_cache_store = new ObjectCacheStore(m_cct);
-  // TODO(dehao): make this configurable
-  int r = m_object_cache_store->init(true);
+  int r = m_object_cache_store->init(
+    !m_cct->_conf.get_val<bool>("immutable_object_cache_warm_restart"));
   if (r < 0) {
     lderr(m_cct) << "init error\n" << dendl;
     return r;
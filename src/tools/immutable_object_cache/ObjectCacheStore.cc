@@ -3,7 +3,10 @@
 
 #include "ObjectCacheStore.h"
 #include "Utils.h"
+#include "common/errno.h"
+#include "include/encoding.h"
 #include <filesystem>
+#include <list>
 
 #define dout_context g_ceph_context
 #define dout_subsys ceph_subsys_immutable_obj_cache
@@ -49,6 +52,11 @@ ObjectCacheStore::ObjectCacheStore(CephContext *cct)
   if (m_cache_root_dir.back() != '/') {
     m_cache_root_dir += "/";
   }
+  // cache files live in numbered sub directories, so these cannot collide
+  // with them
+  m_cache_index_path = m_cache_root_dir + "cache_index";
+  // promotions are written here first and renamed into place once complete
+  m_cache_tmp_dir = m_cache_root_dir + "tmp/";
 
   uint64_t cache_max_size =
     m_cct->_conf.get_val<Option::size_t>("immutable_object_cache_max_size");
@@ -59,6 +67,12 @@ ObjectCacheStore::ObjectCacheStore(CephContext *cct)
   uint64_t max_inflight_ops =
     m_cct->_conf.get_val<uint64_t>("immutable_object_cache_max_inflight_ops");
 
+  uint64_t admission_hits =
+    m_cct->_conf.get_val<uint64_t>("immutable_object_cache_admission_hits");
+
+  uint64_t admission_history =
+    m_cct->_conf.get_val<uint64_t>("immutable_object_cache_admission_history");
+
   uint64_t limit = 0;
   if ((limit = m_cct->_conf.get_val<uint64_t>
                    ("immutable_object_cache_qos_iops_limit")) != 0) {
@@ -88,7 +102,8 @@ ObjectCacheStore::ObjectCacheStore(CephContext *cct)
     cache_watermark = 0.9;
   }
   m_policy = new SimplePolicy(m_cct, cache_max_size, max_inflight_ops,
-                              cache_watermark);
+                              cache_watermark, admission_hits,
+                              admission_history);
 }
 
 ObjectCacheStore::~ObjectCacheStore() {
@@ -118,9 +133,13 @@ int ObjectCacheStore::init(bool reset) {
     return ret;
   }
 
-  // TODO(dehao): fsck and reuse existing cache objects
-  if (reset) {
-    try {
+  // reuse the cache files described by the index saved on the last clean
+  // shutdown; without a usable index everything on disk is wiped
+  if (!reset && load_cache_index() < 0) {
+    reset = true;
+  }
+  try {
+    if (reset) {
       if (fs::exists(m_cache_root_dir)) {
         // remove all sub folders
         for (auto& p : fs::directory_iterator(m_cache_root_dir)) {
@@ -129,11 +148,15 @@ int ObjectCacheStore::init(bool reset) {
       } else {
         fs::create_directories(m_cache_root_dir);
       }
-    } catch (const fs::filesystem_error& e) {
-      lderr(m_cct) << "failed to initialize cache store directory: "
-                   << e.what() << dendl;
-      return -e.code().value();
+    } else {
+      // drop the partial files of promotions in flight at shutdown
+      fs::remove_all(m_cache_tmp_dir);
     }
+    fs::create_directories(m_cache_tmp_dir);
+  } catch (const fs::filesystem_error& e) {
+    lderr(m_cct) << "failed to initialize cache store directory: "
+                 << e.what() << dendl;
+    return -e.code().value();
   }
   return 0;
 }
@@ -142,6 +165,98 @@ int ObjectCacheStore::shutdown() {
   ldout(m_cct, 20) << dendl;
 
   m_rados->shutdown();
+  save_cache_index();
+  return 0;
+}
+
+int ObjectCacheStore::save_cache_index() {
+  std::list<policy_entry_t> entries;
+  m_policy->get_promoted_entries(&entries);
+
+  ldout(m_cct, 20) << "saving " << entries.size() << " entries to "
+                   << m_cache_index_path << dendl;
+
+  bufferlist bl;
+  ENCODE_START(1, 1, bl);
+  encode(static_cast<uint64_t>(entries.size()), bl);
+  for (auto& entry : entries) {
+    encode(entry.file_name, bl);
+    encode(static_cast<uint8_t>(entry.status), bl);
+    encode(entry.size, bl);
+  }
+  ENCODE_FINISH(bl);
+
+  int r = bl.write_file(m_cache_index_path.c_str());
+  if (r < 0) {
+    lderr(m_cct) << "failed to write cache index: " << cpp_strerror(r)
+                 << dendl;
+  }
+  return r;
+}
+
+int ObjectCacheStore::load_cache_index() {
+  bufferlist bl;
+  std::string err;
+  int r = bl.read_file(m_cache_index_path.c_str(), &err);
+  // the index only describes the cache as of the last clean shutdown, do
+  // not let a later crash reuse it
+  std::remove(m_cache_index_path.c_str());
+  if (r < 0) {
+    ldout(m_cct, 5) << "no usable cache index: " << err << dendl;
+    return r;
+  }
+
+  std::list<policy_entry_t> entries;
+  try {
+    auto it = bl.cbegin();
+    DECODE_START(1, it);
+    uint64_t count;
+    decode(count, it);
+    for (uint64_t i = 0; i < count; ++i) {
+      policy_entry_t entry;
+      uint8_t status;
+      decode(entry.file_name, it);
+      decode(status, it);
+      decode(entry.size, it);
+      entry.status = static_cast<cache_status_t>(status);
+      entries.push_back(std::move(entry));
+    }
+    DECODE_FINISH(it);
+  } catch (const buffer::error& e) {
+    lderr(m_cct) << "failed to decode cache index: " << e.what() << dendl;
+    return -EBADMSG;
+  }
+
+  // entries are least recently used first, so loading them in order
+  // restores the LRU
+  uint64_t loaded = 0;
+  for (auto& entry : entries) {
+    std::string cache_file_path = get_cache_file_path(entry.file_name);
+    std::error_code ec;
+    if (entry.status == OBJ_CACHE_PROMOTED) {
+      auto size = fs::file_size(cache_file_path, ec);
+      if (ec || size != entry.size) {
+        ldout(m_cct, 5) << "dropping stale entry: " << entry.file_name
+                        << dendl;
+        fs::remove(cache_file_path, ec);
+        continue;
+      }
+    }
+    r = m_policy->load_promoted_entry(entry);
+    if (r == -EEXIST) {
+      // duplicate, the file belongs to the entry loaded before
+      continue;
+    } else if (r < 0) {
+      // e.g. -ENOSPC once the cache has been shrunk
+      ldout(m_cct, 5) << "dropping entry: " << entry.file_name << ": "
+                      << cpp_strerror(r) << dendl;
+      fs::remove(cache_file_path, ec);
+      continue;
+    }
+    ++loaded;
+  }
+
+  ldout(m_cct, 5) << "reused " << loaded << " cache entries" << dendl;
   return 0;
 }
 
@@ -216,10 +331,18 @@ int ObjectCacheStore::handle_promote_callback(int ret, bufferlist* read_buf,
       return -ENOSPC;
     }
 
-    ret = read_buf->write_file(cache_file_path.c_str());
+    // only complete files ever appear under their cache file path, so a
+    // restart never has to look for partial ones there
+    std::string tmp_file_path = m_cache_tmp_dir + cache_file_name;
+    ret = read_buf->write_file(tmp_file_path.c_str());
+    if (ret >= 0 &&
+        ::rename(tmp_file_path.c_str(), cache_file_path.c_str()) < 0) {
+      ret = -errno;
+    }
     if (ret < 0) {
       lderr(m_cct) << "fail to write cache file" << dendl;
 
+      std::remove(tmp_file_path.c_str());
       m_policy->update_status(cache_file_name, OBJ_CACHE_NONE);
       delete read_buf;
       return ret;
@@ -55,6 +55,8 @@ class ObjectCacheStore {
                      Context* on_finish);
   int handle_promote_callback(int, bufferlist*, std::string);
   int do_evict(std::string cache_file);
+  int save_cache_index();
+  int load_cache_index();
 
   bool take_token_from_throttle(uint64_t object_size, uint64_t object_num);
   void handle_throttle_ready(uint64_t tokens, uint64_t type);
@@ -70,6 +72,8 @@ class ObjectCacheStore {
     ceph::make_mutex("ceph::cache::ObjectCacheStore::m_ioctx_map_lock");
   Policy* m_policy;
   std::string m_cache_root_dir;
+  std::string m_cache_index_path;
+  std::string m_cache_tmp_dir;
   // throttle mechanism
   uint64_t m_qos_enabled_flag{0};
   std::map<uint64_t, TokenBucketThrottle*> m_throttles;
@@ -4,6 +4,7 @@
 #ifndef CEPH_CACHE_POLICY_H
 #define CEPH_CACHE_POLICY_H
 
+#include <cstdint>
 #include <list>
 #include <string>
 
@@ -17,6 +18,12 @@ typedef enum {
   OBJ_CACHE_DNE,
 } cache_status_t;
 
+struct policy_entry_t {
+  std::string file_name;
+  cache_status_t status;
+  uint64_t size;
+};
+
 class Policy {
  public:
   Policy() {}
@@ -27,6 +34,9 @@ class Policy {
                              uint64_t size = 0) = 0;
   virtual cache_status_t get_status(std::string) = 0;
   virtual void get_evict_list(std::list<std::string>* obj_list) = 0;
+  // cached entries, least recently used first
+  virtual void get_promoted_entries(std::list<policy_entry_t>* entries) = 0;
+  virtual int load_promoted_entry(const policy_entry_t& entry) = 0;
 };
 
 }  // namespace immutable_obj_cache
@@ -14,13 +14,17 @@ namespace ceph {
 namespace immutable_obj_cache {
 
 SimplePolicy::SimplePolicy(CephContext *cct, uint64_t cache_size,
-                           uint64_t max_inflight, double watermark)
+                           uint64_t max_inflight, double watermark,
+                           uint64_t admission_hits, uint64_t admission_history)
   : cct(cct), m_watermark(watermark), m_max_inflight_ops(max_inflight),
-    m_max_cache_size(cache_size) {
+    m_max_cache_size(cache_size),
+    m_admission_hits(admission_hits ? admission_hits : 1),
+    m_admission_history(admission_history ? admission_history : 1) {
 
   ldout(cct, 20) << "max cache size= " << m_max_cache_size
                  << " ,watermark= " << m_watermark
-                 << " ,max inflight ops= " << m_max_inflight_ops << dendl;
+                 << " ,max inflight ops= " << m_max_inflight_ops
+                 << " ,admission hits= " << m_admission_hits << dendl;
 
   m_cache_size = 0;
 
@@ -66,10 +70,17 @@ cache_status_t SimplePolicy::lookup_object(std::string file_name) {
   std::shared_lock rlocker{m_cache_map_lock};
 
   auto entry_it = m_cache_map.find(file_name);
-  // simply promote on first lookup
   if (entry_it == m_cache_map.end()) {
-      rlocker.unlock();
-      return alloc_entry(file_name);
+    rlocker.unlock();
+    if (!admit(file_name)) {
+      // not seen often enough yet, read from rados
+      return OBJ_CACHE_SKIP;
+    }
+    cache_status_t ret = alloc_entry(file_name);
+    if (ret == OBJ_CACHE_NONE) {
+      forget(file_name);
+    }
+    return ret;
   }
 
   Entry* entry = entry_it->second;
@@ -141,8 +152,70 @@ void SimplePolicy::update_status(std::string file_name,
     m_cache_map.erase(entry_it);
     m_cache_size -= size;
     delete entry;
+    remember_evicted(file_name);
+    return;
+  }
+}
+
+bool SimplePolicy::admit(const std::string& file_name) {
+  if (m_admission_hits <= 1) {
+    return true;
+  }
+
+  std::lock_guard locker{m_history_lock};
+  auto it = m_history.find(file_name);
+  if (it == m_history.end()) {
+    m_history_lru.push_back(file_name);
+    m_history.emplace(file_name,
+                      std::make_pair(1, std::prev(m_history_lru.end())));
+    trim_history();
+    return false;
+  }
+
+  m_history_lru.splice(m_history_lru.end(), m_history_lru, it->second.second);
+  if (it->second.first < m_admission_hits) {
+    it->second.first++;
+  }
+  return it->second.first >= m_admission_hits;
+}
+
+void SimplePolicy::forget(const std::string& file_name) {
+  if (m_admission_hits <= 1) {
     return;
   }
+
+  std::lock_guard locker{m_history_lock};
+  auto it = m_history.find(file_name);
+  if (it != m_history.end()) {
+    m_history_lru.erase(it->second.second);
+    m_history.erase(it);
+  }
+}
+
+void SimplePolicy::remember_evicted(const std::string& file_name) {
+  if (m_admission_hits <= 1) {
+    return;
+  }
+
+  std::lock_guard locker{m_history_lock};
+  auto it = m_history.find(file_name);
+  if (it != m_history.end()) {
+    m_history_lru.erase(it->second.second);
+    m_history.erase(it);
+  }
+  // one more hit re-admits it
+  m_history_lru.push_back(file_name);
+  m_history.emplace(file_name, std::make_pair(m_admission_hits - 1,
+                                              std::prev(m_history_lru.end())));
+  trim_history();
+}
+
+void SimplePolicy::trim_history() {
+  ceph_assert(ceph_mutex_is_locked(m_history_lock));
+  while (m_history_lru.size() > m_admission_history) {
+    m_history.erase(m_history_lru.front());
+    m_history_lru.pop_front();
+  }
 }
 
 int SimplePolicy::evict_entry(std::string file_name) {
@@ -184,6 +257,51 @@ void SimplePolicy::get_evict_list(std::list<std::string>* obj_list) {
   }
 }
 
+void SimplePolicy::get_promoted_entries(std::list<policy_entry_t>* entries) {
+  ldout(cct, 20) << dendl;
+
+  std::unique_lock locker{m_cache_map_lock};
+  // drain the LRU from the cold end and put everything back in the same
+  // order, since LRU cannot be walked in place
+  std::vector<Entry*> promoted;
+  promoted.reserve(m_promoted_lru.lru_get_size());
+  LRUObject* o;
+  while ((o = m_promoted_lru.lru_expire()) != nullptr) {
+    promoted.push_back(reinterpret_cast<Entry*>(o));
+  }
+  for (auto entry : promoted) {
+    m_promoted_lru.lru_insert_top(entry);
+    entries->push_back({entry->file_name, entry->status, entry->size});
+  }
+}
+
+int SimplePolicy::load_promoted_entry(const policy_entry_t& entry) {
+  ldout(cct, 20) << "load: " << entry.file_name
+                 << " status = " << entry.status
+                 << " size = " << entry.size << dendl;
+
+  if (entry.status != OBJ_CACHE_PROMOTED && entry.status != OBJ_CACHE_DNE) {
+    return -EINVAL;
+  }
+
+  std::unique_lock locker{m_cache_map_lock};
+  if (m_cache_map.find(entry.file_name) != m_cache_map.end()) {
+    return -EEXIST;
+  }
+  if (m_cache_size + entry.size > m_max_cache_size) {
+    return -ENOSPC;
+  }
+
+  Entry* e = new Entry();
+  e->status = entry.status;
+  e->file_name = entry.file_name;
+  e->size = entry.size;
+  m_cache_map[entry.file_name] = e;
+  m_promoted_lru.lru_insert_top(e);
+  m_cache_size += e->size;
+  return 0;
+}
+
 // for unit test
 uint64_t SimplePolicy::get_free_size() {
   return m_max_cache_size - m_cache_size;
@@ -204,6 +322,11 @@ uint64_t SimplePolicy::get_promoted_entry_num() {
   return m_promoted_lru.lru_get_size();
 }
 
+uint64_t SimplePolicy::get_history_entry_num() {
+  std::lock_guard locker{m_history_lock};
+  return m_history.size();
+}
+
 std::string SimplePolicy::get_evict_entry() {
   Entry* entry = reinterpret_cast<Entry*>(m_promoted_lru.lru_get_next_expire());
   if (entry == nullptr) {
@@ -9,6 +9,7 @@
 #include "include/lru.h"
 #include "Policy.h"
 
+#include <list>
 #include <unordered_map>
 #include <string>
 
@@ -18,7 +19,8 @@ namespace immutable_obj_cache {
 class SimplePolicy : public Policy {
  public:
   SimplePolicy(CephContext *cct, uint64_t block_num, uint64_t max_inflight,
-               double watermark);
+               double watermark, uint64_t admission_hits = 1,
+               uint64_t admission_history = 65536);
   ~SimplePolicy();
 
   cache_status_t lookup_object(std::string file_name);
@@ -32,13 +34,21 @@ class SimplePolicy : public Policy {
 
   void get_evict_list(std::list<std::string>* obj_list);
 
+  void get_promoted_entries(std::list<policy_entry_t>* entries);
+  int load_promoted_entry(const policy_entry_t& entry);
+
   uint64_t get_free_size();
   uint64_t get_promoting_entry_num();
   uint64_t get_promoted_entry_num();
   std::string get_evict_entry();
+  uint64_t get_history_entry_num();
 
  private:
   cache_status_t alloc_entry(std::string file_name);
+  bool admit(const std::string& file_name);
+  void forget(const std::string& file_name);
+  void remember_evicted(const std::string& file_name);
+  void trim_history();
 
   class Entry : public LRUObject {
    public:
@@ -61,6 +71,20 @@ class SimplePolicy : public Policy {
   std::atomic<uint64_t> m_cache_size;
 
   LRU m_promoted_lru;
+
+  // 2Q-style admission: an object is only promoted once it has been looked
+  // up m_admission_hits times while remembered in the history, so one-off
+  // reads of cold parent objects do not push out the working set.  recently
+  // evicted objects are remembered as well and are promoted again on their
+  // next lookup.
+  uint64_t m_admission_hits;
+  uint64_t m_admission_history;
+  typedef std::list<std::string> HistoryLRU;
+  HistoryLRU m_history_lru;  // oldest first
+  std::unordered_map<std::string,
+                     std::pair<uint64_t, HistoryLRU::iterator>> m_history;
+  ceph::mutex m_history_lock =
+    ceph::make_mutex("rbd::cache::SimplePolicy::m_history_lock");
 };
 
 }  // namespace immutable_obj_cache
@@ -386,6 +386,146 @@ private:
   int m_fd;
 };
 
+class C_ExportExtent : public Context
+{
+public:
+  C_ExportExtent(SimpleThrottle &simple_throttle, librbd::Image &image,
+                 uint64_t offset, uint64_t length, int fd)
+    : m_throttle(simple_throttle), m_image(image), m_offset(offset),
+      m_length(length), m_fd(fd)
+  {
+  }
+
+  void send()
+  {
+    m_throttle.start_op();
+    auto aio_completion = new librbd::RBD::AioCompletion(
+      this, &utils::aio_context_callback);
+    int op_flags = LIBRADOS_OP_FLAG_FADVISE_SEQUENTIAL |
+                   LIBRADOS_OP_FLAG_FADVISE_NOCACHE;
+    int r = m_image.aio_read2(m_offset, m_length, m_bufferlist,
+                              aio_completion, op_flags);
+    if (r < 0) {
+      cerr << "rbd: error requesting read from source image" << std::endl;
+      aio_completion->release();
+      m_throttle.end_op(r);
+      delete this;
+    }
+  }
+
+  void finish(int r) override
+  {
+    BOOST_SCOPE_EXIT((&m_throttle) (&r))
+    {
+      m_throttle.end_op(r);
+    } BOOST_SCOPE_EXIT_END
+
+    if (r < 0) {
+      cerr << "rbd: error reading from source image at offset "
+           << m_offset << ": " << cpp_strerror(r) << std::endl;
+      return;
+    }
+
+    ceph_assert(m_bufferlist.length() == static_cast<size_t>(r));
+    if (m_bufferlist.is_zero()) {
+      return;
+    }
+
+    // positional write: extents complete and land in any order
+    r = m_bufferlist.write_fd(m_fd, m_offset);
+    if (r < 0) {
+      cerr << "rbd: error writing to destination image at offset "
+           << m_offset << std::endl;
+    }
+  }
+
+private:
+  SimpleThrottle &m_throttle;
+  librbd::Image &m_image;
+  bufferlist m_bufferlist;
+  uint64_t m_offset;
+  uint64_t m_length;
+  int m_fd;
+};
+
+struct ExportExtentsContext {
+  librbd::Image &image;
+  int fd;
+  uint64_t period;
+  uint64_t size;
+  SimpleThrottle &throttle;
+  utils::ProgressContext &pc;
+};
+
+static int export_extent_cb(uint64_t offset, size_t length, int exists,
+                            void *arg)
+{
+  auto eec = reinterpret_cast<ExportExtentsContext *>(arg);
+  if (!exists) {
+    return 0;
+  }
+
+  uint64_t end = offset + length;
+  while (offset < end) {
+    if (eec->throttle.pending_error()) {
+      return eec->throttle.wait_for_ret();
+    }
+
+    uint64_t chunk = std::min(eec->period - offset % eec->period,
+                              end - offset);
+    auto ctx = new C_ExportExtent(eec->throttle, eec->image, offset, chunk,
+                                  eec->fd);
+    ctx->send();
+    offset += chunk;
+
+    eec->pc.update_progress(offset, eec->size);
+  }
+  return 0;
+}
+
+/**
+ * Export to a regular file: unlike a stream, it can be written out of order
+ * with pwrite, so extents do not wait for the ones before them, and the
+ * parts of the image that fast-diff reports as unallocated are never read
+ * and are left as holes.
+ */
+static int do_export_v1_file(librbd::Image& image, librbd::image_info_t &info,
+                             int fd, uint64_t period, int max_concurrent_ops,
+                             utils::ProgressContext &pc)
+{
+  uint64_t features = 0;
+  uint64_t flags = 0;
+  int r = image.features(&features);
+  if (r >= 0) {
+    r = image.get_flags(&flags);
+  }
+  bool sparse = (r >= 0 && (features & RBD_FEATURE_FAST_DIFF) != 0 &&
+                 (flags & RBD_FLAG_FAST_DIFF_INVALID) == 0);
+
+  SimpleThrottle throttle(max_concurrent_ops, false);
+  ExportExtentsContext eec{image, fd, period, info.size, throttle, pc};
+  if (sparse) {
+    r = image.diff_iterate2(nullptr, 0, info.size, true, true,
+                            &export_extent_cb, &eec);
+  } else {
+    r = export_extent_cb(0, info.size, true, &eec);
+  }
+
+  int ret = throttle.wait_for_ret();
+  if (r >= 0) {
+    r = ret;
+  }
+  if (r < 0) {
+    return r;
+  }
+
+  r = ftruncate(fd, info.size);
+  if (r < 0) {
+    return -errno;
+  }
+  return 0;
+}
+
 const uint32_t MAX_KEYS = 64;
 
 static int do_export_v2(librbd::Image& image, librbd::image_info_t &info, int fd,
@@ -572,14 +712,19 @@ static int do_export(librbd::Image& image, const char *path, bool no_progress,
       return -errno;
     }
 #ifdef HAVE_POSIX_FADVISE
-    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    // the v1 file export writes completions out of order and skips holes
+    if (export_format != 1) {
+      posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
 #endif
   }
 
   utils::ProgressContext pc("Exporting image", no_progress);
   uint64_t period = image.get_stripe_count() * (1ull << info.order);
 
-  if (export_format == 1)
+  if (export_format == 1 && !to_stdout)
+    r = do_export_v1_file(image, info, fd, period, max_concurrent_ops, pc);
+  else if (export_format == 1)
     r = do_export_v1(image, info, fd, period, max_concurrent_ops, pc);
   else
     r = do_export_v2(image, info, fd, period, max_concurrent_ops, pc);
@@ -7,6 +7,7 @@
 #include "common/debug.h"
 #include "common/Timer.h"
 #include "common/errno.h"
+#include "include/types.h"
 #include "librbd/DeepCopyRequest.h"
 #include "librbd/ImageCtx.h"
 #include "librbd/ImageState.h"
@@ -40,6 +41,14 @@ public:
   ImageCopyProgressHandler(ImageSync *image_sync) : image_sync(image_sync) {
   }
 
+  void handle_read(uint64_t bytes_read) override {
+    image_sync->m_image_copy_bytes += bytes_read;
+  }
+
+  uint64_t get_max_concurrent_ops() override {
+    return image_sync->m_max_concurrent_ops;
+  }
+
   int update_progress(uint64_t object_no, uint64_t object_count) override {
     image_sync->handle_copy_image_update_progress(object_no, object_count);
     return 0;
@@ -70,7 +79,10 @@ ImageSync<I>::ImageSync(
     m_lock(ceph::make_mutex(unique_lock_name("ImageSync::m_lock", this))),
     m_update_sync_point_interval(
       m_local_image_ctx->cct->_conf.template get_val<double>(
-        "rbd_mirror_sync_point_update_age")) {
+        "rbd_mirror_sync_point_update_age")),
+    m_max_concurrent_ops(
+      m_local_image_ctx->cct->_conf.template get_val<uint64_t>(
+        "rbd_mirror_concurrent_object_copies")) {
 }
 
 template <typename I>
@@ -256,6 +268,8 @@ void ImageSync<I>::send_copy_image() {
   Context *ctx = create_context_callback<
     ImageSync<I>, &ImageSync<I>::handle_copy_image>(this);
   m_image_copy_prog_handler = new ImageCopyProgressHandler(this);
+  m_image_copy_bytes = 0;
+  m_image_copy_start_time = ceph::mono_clock::now();
   m_image_copy_request = librbd::DeepCopyRequest<I>::create(
       m_remote_image_ctx, m_local_image_ctx, snap_id_start, snap_id_end,
       0, false, object_number, m_threads->work_queue, &m_snap_seqs_copy,
@@ -303,6 +317,8 @@ void ImageSync<I>::handle_copy_image(int r) {
     return;
   }
 
+  dout(10) << ": copied " << byte_u_t(m_image_copy_bytes) << " at "
+           << byte_u_t(get_image_copy_bytes_per_second()) << "/s" << dendl;
   send_flush_sync_point();
 }
 
@@ -310,7 +326,9 @@ template <typename I>
 void ImageSync<I>::handle_copy_image_update_progress(uint64_t object_no,
                                                      uint64_t object_count) {
   int percent = 100 * object_no / object_count;
-  update_progress("COPY_IMAGE " + stringify(percent) + "%");
+  update_progress("COPY_IMAGE " + stringify(percent) + "% (" +
+                  stringify(byte_u_t(get_image_copy_bytes_per_second())) +
+                  "/s)");
 
   std::lock_guard locker{m_lock};
   m_image_copy_object_no = object_no;
@@ -321,6 +339,16 @@ void ImageSync<I>::handle_copy_image_update_progress(uint64_t object_no,
   }
 }
 
+template <typename I>
+uint64_t ImageSync<I>::get_image_copy_bytes_per_second() const {
+  auto elapsed = std::chrono::duration<double>(
+    ceph::mono_clock::now() - m_image_copy_start_time).count();
+  if (elapsed <= 0) {
+    return 0;
+  }
+  return m_image_copy_bytes / elapsed;
+}
+
 template <typename I>
 void ImageSync<I>::send_update_sync_point() {
   ceph_assert(ceph_mutex_is_locked(m_lock));
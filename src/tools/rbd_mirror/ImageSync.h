@@ -5,9 +5,11 @@
 #define RBD_MIRROR_IMAGE_SYNC_H
 
 #include "include/int_types.h"
+#include <atomic>
 #include "librbd/ImageCtx.h"
 #include "librbd/Types.h"
 #include "common/ceph_mutex.h"
+#include "common/ceph_time.h"
 #include "tools/rbd_mirror/CancelableRequest.h"
 #include "tools/rbd_mirror/image_sync/Types.h"
 
@@ -109,6 +111,10 @@ private:
   double m_update_sync_point_interval;
   uint64_t m_image_copy_object_no = 0;
   uint64_t m_image_copy_object_count = 0;
+  uint64_t m_max_concurrent_ops;
+
+  std::atomic<uint64_t> m_image_copy_bytes = {0};
+  ceph::mono_time m_image_copy_start_time;
 
   librbd::SnapSeqs m_snap_seqs_copy;
   image_sync::SyncPoints m_sync_points_copy;
@@ -131,6 +137,8 @@ private:
   void handle_copy_image(int r);
   void handle_copy_image_update_progress(uint64_t object_no,
                                          uint64_t object_count);
+  uint64_t get_image_copy_bytes_per_second() const;
+
   void send_update_sync_point();
   void handle_update_sync_point(int r);
 
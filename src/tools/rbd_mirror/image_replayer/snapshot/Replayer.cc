@@ -99,6 +99,12 @@ struct Replayer<I>::DeepCopyHandler : public librbd::deep_copy::Handler {
     replayer->handle_copy_image_read(bytes_read);
   }
 
+  uint64_t get_max_concurrent_ops() override {
+    auto cct = replayer->m_state_builder->local_image_ctx->cct;
+    return cct->_conf.template get_val<uint64_t>(
+      "rbd_mirror_concurrent_object_copies");
+  }
+
   int update_progress(uint64_t object_number, uint64_t object_count) override {
     replayer->handle_copy_image_progress(object_number, object_count);
     return 0;
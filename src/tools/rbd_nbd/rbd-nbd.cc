@@ -46,6 +46,7 @@
 
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <regex>
@@ -100,6 +101,7 @@ struct Config {
   int max_part = 255;
   int io_timeout = -1;
   int reattach_timeout = 30;
+  int num_connections = 1;
 
   bool exclusive = false;
   bool notrim = false;
@@ -159,6 +161,8 @@ static void usage()
             << "  --io-timeout <sec>            Set nbd IO timeout\n"
             << "  --max_part <limit>            Override for module param max_part\n"
             << "  --nbds_max <limit>            Override for module param nbds_max\n"
+            << "  --num-connections <num>       Number of sockets to serve the device over\n"
+            << "                                (requires the netlink interface, default: 1)\n"
             << "  --quiesce                     Use quiesce callbacks\n"
             << "  --quiesce-hook <path>         Specify quiesce hook path\n"
             << "                                (default: " << Config().quiesce_hook << ")\n"
@@ -202,19 +206,22 @@ public:
   uint64_t quiesce_watch_handle = 0;
 
 private:
-  int fd;
+  struct Connection;
+
   librbd::Image &image;
   Config *cfg;
+  std::vector<std::unique_ptr<Connection>> connections;
 
 public:
-  NBDServer(int fd, librbd::Image& image, Config *cfg)
-    : fd(fd)
-    , image(image)
+  NBDServer(const std::vector<int>& fds, librbd::Image& image, Config *cfg)
+    : image(image)
     , cfg(cfg)
-    , reader_thread(*this, &NBDServer::reader_entry)
-    , writer_thread(*this, &NBDServer::writer_entry)
-    , quiesce_thread(*this, &NBDServer::quiesce_entry)
+    , quiesce_thread([this] { quiesce_entry(); })
   {
+    for (auto fd : fds) {
+      connections.push_back(std::make_unique<Connection>(this, fd));
+    }
+
     std::vector<librbd::config_option_t> options;
     image.config_list(&options);
     for (auto &option : options) {
@@ -243,6 +250,7 @@ private:
   {
     xlist<IOContext*>::item item;
     NBDServer *server = nullptr;
+    Connection *conn = nullptr;
     struct nbd_request request;
     struct nbd_reply reply;
     bufferlist data;
@@ -255,62 +263,121 @@ private:
 
   friend std::ostream &operator<<(std::ostream &os, const IOContext &ctx);
 
+  class ThreadHelper : public Thread
+  {
+  private:
+    std::function<void()> func;
+  public:
+    ThreadHelper(std::function<void()>&& func)
+      : func(std::move(func))
+    {}
+  protected:
+    void* entry() override
+    {
+      func();
+      return NULL;
+    }
+  };
+
+  // each nbd socket is served by its own reader/writer pair so that the
+  // kernel can spread requests from its hardware queues over them
+  struct Connection
+  {
+    NBDServer *server;
+    int fd;
+
+    ceph::mutex lock = ceph::make_mutex("NBDServer::Connection::Locker");
+    ceph::condition_variable cond;
+    xlist<IOContext*> io_pending;
+    xlist<IOContext*> io_finished;
+    // set by this connection's reader once it stops starting new requests
+    bool reader_done = false;
+
+    ThreadHelper reader_thread;
+    ThreadHelper writer_thread;
+
+    Connection(NBDServer *server, int fd)
+      : server(server)
+      , fd(fd)
+      , reader_thread([this] { this->server->reader_entry(this); })
+      , writer_thread([this] { this->server->writer_entry(this); })
+    {}
+  };
+
   ceph::mutex lock = ceph::make_mutex("NBDServer::Locker");
   ceph::condition_variable cond;
-  xlist<IOContext*> io_pending;
-  xlist<IOContext*> io_finished;
 
   void io_start(IOContext *ctx)
   {
-    std::lock_guard l{lock};
-    io_pending.push_back(&ctx->item);
+    auto conn = ctx->conn;
+    std::lock_guard l{conn->lock};
+    conn->io_pending.push_back(&ctx->item);
   }
 
   void io_finish(IOContext *ctx)
   {
-    std::lock_guard l{lock};
+    auto conn = ctx->conn;
+    std::lock_guard l{conn->lock};
     ceph_assert(ctx->item.is_on_list());
     ctx->item.remove_myself();
-    io_finished.push_back(&ctx->item);
-    cond.notify_all();
+    conn->io_finished.push_back(&ctx->item);
+    conn->cond.notify_all();
   }
 
-  IOContext *wait_io_finish()
+  IOContext *wait_io_finish(Connection *conn)
   {
-    std::unique_lock l{lock};
-    cond.wait(l, [this] {
-                   return !io_finished.empty() ||
-                          (io_pending.empty() && terminated);
-                 });
+    std::unique_lock l{conn->lock};
+    conn->cond.wait(l, [conn] {
+                         return !conn->io_finished.empty() ||
+                                (conn->io_pending.empty() && conn->reader_done);
+                       });
 
-    if (io_finished.empty())
+    if (conn->io_finished.empty())
       return NULL;
 
-    IOContext *ret = io_finished.front();
-    io_finished.pop_front();
+    IOContext *ret = conn->io_finished.front();
+    conn->io_finished.pop_front();
 
     return ret;
   }
 
-  void wait_clean()
+  void wait_clean(Connection *conn)
   {
-    std::unique_lock l{lock};
-    cond.wait(l, [this] { return io_pending.empty(); });
-
-    while(!io_finished.empty()) {
-      std::unique_ptr<IOContext> free_ctx(io_finished.front());
-      io_finished.pop_front();
+    std::unique_lock l{conn->lock};
+    conn->cond.wait(l, [conn] {
+                         return conn->io_pending.empty() && conn->reader_done;
+                       });
+
+    while(!conn->io_finished.empty()) {
+      std::unique_ptr<IOContext> free_ctx(conn->io_finished.front());
+      conn->io_finished.pop_front();
     }
   }
 
   void assert_clean()
   {
-    std::unique_lock l{lock};
+    for (auto& conn : connections) {
+      std::unique_lock l{conn->lock};
+
+      ceph_assert(!conn->reader_thread.is_started());
+      ceph_assert(!conn->writer_thread.is_started());
+      ceph_assert(conn->io_pending.empty());
+      ceph_assert(conn->io_finished.empty());
+    }
+  }
+
+  void notify_reader_done(Connection *conn)
+  {
+    std::lock_guard l{conn->lock};
+    conn->reader_done = true;
+    conn->cond.notify_all();
+  }
 
-    ceph_assert(!reader_thread.is_started());
-    ceph_assert(!writer_thread.is_started());
-    ceph_assert(io_pending.empty());
-    ceph_assert(io_finished.empty());
+  void notify_terminated()
+  {
+    terminated = true;
+    std::lock_guard l{lock};
+    cond.notify_all();
   }
 
   static void aio_callback(librbd::completion_t cb, void *arg)
@@ -348,8 +415,9 @@ private:
     aio_completion->release();
   }
 
-  void reader_entry()
+  void reader_entry(Connection *conn)
   {
+    int fd = conn->fd;
     struct pollfd poll_fds[2];
     memset(poll_fds, 0, sizeof(struct pollfd) * 2);
     poll_fds[0].fd = fd;
@@ -360,6 +428,7 @@ private:
     while (true) {
       std::unique_ptr<IOContext> ctx(new IOContext());
       ctx->server = this;
+      ctx->conn = conn;
 
       dout(20) << __func__ << ": waiting for nbd request" << dendl;
 
@@ -456,9 +525,8 @@ error:
       }
     }
 signal:
-    std::lock_guard l{lock};
-    terminated = true;
-    cond.notify_all();
+    notify_reader_done(conn);
+    notify_terminated();
 
     std::lock_guard disconnect_l{disconnect_lock};
     disconnect_cond.notify_all();
@@ -466,11 +534,12 @@ signal:
     dout(20) << __func__ << ": terminated" << dendl;
   }
 
-  void writer_entry()
+  void writer_entry(Connection *conn)
   {
+    int fd = conn->fd;
     while (true) {
       dout(20) << __func__ << ": waiting for io request" << dendl;
-      std::unique_ptr<IOContext> ctx(wait_io_finish());
+      std::unique_ptr<IOContext> ctx(wait_io_finish(conn));
       if (!ctx) {
 	dout(20) << __func__ << ": no io requests, terminating" << dendl;
         goto done;
@@ -495,7 +564,9 @@ signal:
       dout(20) << *ctx << ": finish" << dendl;
     }
   error:
-    wait_clean();
+    // stop the reader before dropping what it may still queue
+    ::shutdown(fd, SHUT_RDWR);
+    wait_clean(conn);
   done:
     ::shutdown(fd, SHUT_RDWR);
 
@@ -577,25 +648,7 @@ signal:
     dout(20) << __func__ << ": terminated" << dendl;
   }
 
-  class ThreadHelper : public Thread
-  {
-  public:
-    typedef void (NBDServer::*entry_func)();
-  private:
-    NBDServer &server;
-    entry_func func;
-  public:
-    ThreadHelper(NBDServer &_server, entry_func _func)
-      :server(_server)
-      ,func(_func)
-    {}
-  protected:
-    void* entry() override
-    {
-      (server.*func)();
-      return NULL;
-    }
-  } reader_thread, writer_thread, quiesce_thread;
+  ThreadHelper quiesce_thread;
 
   bool started = false;
   bool quiesce = false;
@@ -614,8 +667,10 @@ public:
                                         EVENT_SOCKET_TYPE_EVENTFD);
       ceph_assert(r >= 0);
 
-      reader_thread.create("rbd_reader");
-      writer_thread.create("rbd_writer");
+      for (auto& conn : connections) {
+        conn->reader_thread.create("rbd_reader");
+        conn->writer_thread.create("rbd_writer");
+      }
       if (cfg->quiesce) {
         quiesce_thread.create("rbd_quiesce");
       }
@@ -660,8 +715,10 @@ public:
 
       terminate_event_sock.notify();
 
-      reader_thread.join();
-      writer_thread.join();
+      for (auto& conn : connections) {
+        conn->reader_thread.join();
+        conn->writer_thread.join();
+      }
       if (cfg->quiesce) {
         quiesce_thread.join();
       }
@@ -1300,8 +1357,9 @@ static int netlink_connect_cb(struct nl_msg *msg, void *arg)
   return NL_OK;
 }
 
-static int netlink_connect(Config *cfg, struct nl_sock *sock, int nl_id, int fd,
-                           uint64_t size, uint64_t flags, bool reconnect)
+static int netlink_connect(Config *cfg, struct nl_sock *sock, int nl_id,
+                           const std::vector<int> &fds, uint64_t size,
+                           uint64_t flags, bool reconnect)
 {
   struct nlattr *sock_attr;
   struct nlattr *sock_opt;
@@ -1356,14 +1414,16 @@ static int netlink_connect(Config *cfg, struct nl_sock *sock, int nl_id, int fd,
     goto free_msg;
   }
 
-  sock_opt = nla_nest_start(msg, NBD_SOCK_ITEM);
-  if (!sock_opt) {
-    cerr << "rbd-nbd: Could not init sock in netlink message." << std::endl;
-    goto free_msg;
-  }
+  for (auto fd : fds) {
+    sock_opt = nla_nest_start(msg, NBD_SOCK_ITEM);
+    if (!sock_opt) {
+      cerr << "rbd-nbd: Could not init sock in netlink message." << std::endl;
+      goto free_msg;
+    }
 
-  NLA_PUT_U32(msg, NBD_SOCK_FD, fd);
-  nla_nest_end(msg, sock_opt);
+    NLA_PUT_U32(msg, NBD_SOCK_FD, fd);
+    nla_nest_end(msg, sock_opt);
+  }
   nla_nest_end(msg, sock_attr);
 
   ret = nl_send_sync(sock, msg);
@@ -1382,14 +1442,19 @@ free_msg:
   return -EIO;
 }
 
-static int try_netlink_setup(Config *cfg, int fd, uint64_t size, uint64_t flags,
-                             bool reconnect)
+static int try_netlink_setup(Config *cfg, const std::vector<int> &fds,
+                             uint64_t size, uint64_t flags, bool reconnect)
 {
   struct nl_sock *sock;
   int nl_id, ret;
 
   sock = netlink_init(&nl_id);
   if (!sock) {
+    if (fds.size() > 1) {
+      cerr << "rbd-nbd: Netlink interface not supported, required for "
+           << "multiple connections." << std::endl;
+      return -EOPNOTSUPP;
+    }
     cerr << "rbd-nbd: Netlink interface not supported. Using ioctl interface."
          << std::endl;
     return 1;
@@ -1397,7 +1462,7 @@ static int try_netlink_setup(Config *cfg, int fd, uint64_t size, uint64_t flags,
 
   dout(10) << "netlink interface supported." << dendl;
 
-  ret = netlink_connect(cfg, sock, nl_id, fd, size, flags, reconnect);
+  ret = netlink_connect(cfg, sock, nl_id, fds, size, flags, reconnect);
   netlink_cleanup(sock);
 
   if (ret != 0)
@@ -1453,11 +1518,12 @@ static void handle_signal(int signum)
   terminate_event_sock.notify();
 }
 
-static NBDServer *start_server(int fd, librbd::Image& image, Config *cfg)
+static NBDServer *start_server(const std::vector<int> &fds,
+                               librbd::Image& image, Config *cfg)
 {
   NBDServer *server;
 
-  server = new NBDServer(fd, image, cfg);
+  server = new NBDServer(fds, image, cfg);
   server->start();
 
   init_async_signal_handler();
@@ -1583,7 +1649,9 @@ static int do_map(int argc, const char *argv[], Config *cfg, bool reconnect)
   unsigned long blksize = RBD_NBD_BLKSIZE;
   bool use_netlink;
 
-  int fd[2];
+  // kernel and server ends of each nbd connection
+  std::vector<int> client_fds;
+  std::vector<int> server_fds;
 
   librbd::image_info_t info;
 
@@ -1624,9 +1692,14 @@ static int do_map(int argc, const char *argv[], Config *cfg, bool reconnect)
   common_init_finish(g_ceph_context);
   global_init_chdir(g_ceph_context);
 
-  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fd) == -1) {
-    r = -errno;
-    goto close_ret;
+  for (int i = 0; i < cfg->num_connections; i++) {
+    int fd[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fd) == -1) {
+      r = -errno;
+      goto close_fd;
+    }
+    client_fds.push_back(fd[0]);
+    server_fds.push_back(fd[1]);
   }
 
   r = rados.init_with_context(g_ceph_context);
@@ -1725,6 +1798,11 @@ static int do_map(int argc, const char *argv[], Config *cfg, bool reconnect)
     flags |= NBD_FLAG_READ_ONLY;
     read_only = 1;
   }
+  if (cfg->num_connections > 1) {
+    // all connections are served by the same image so a flush on any of
+    // them covers the writes completed on the others
+    flags |= NBD_FLAG_CAN_MULTI_CONN;
+  }
 
   if (info.size > ULONG_MAX) {
     r = -EFBIG;
@@ -1739,7 +1817,7 @@ static int do_map(int argc, const char *argv[], Config *cfg, bool reconnect)
   if (r < 0)
     goto close_fd;
 
-  server = start_server(fd[1], image, cfg);
+  server = start_server(server_fds, image, cfg);
 
   use_netlink = cfg->try_netlink || reconnect;
   if (use_netlink) {
@@ -1749,7 +1827,7 @@ static int do_map(int argc, const char *argv[], Config *cfg, bool reconnect)
       uuid_gen.generate_random();
       cfg->cookie = uuid_gen.to_string();
     }
-    r = try_netlink_setup(cfg, fd[0], size, flags, reconnect);
+    r = try_netlink_setup(cfg, client_fds, size, flags, reconnect);
     if (r < 0) {
       goto free_server;
     } else if (r == 1) {
@@ -1758,7 +1836,7 @@ static int do_map(int argc, const char *argv[], Config *cfg, bool reconnect)
   }
 
   if (!use_netlink) {
-    r = try_ioctl_setup(cfg, fd[0], size, blksize, flags);
+    r = try_ioctl_setup(cfg, client_fds[0], size, blksize, flags);
     if (r < 0)
       goto free_server;
   }
@@ -1827,9 +1905,12 @@ close_nbd:
 free_server:
   delete server;
 close_fd:
-  close(fd[0]);
-  close(fd[1]);
-close_ret:
+  for (auto fd : client_fds) {
+    close(fd);
+  }
+  for (auto fd : server_fds) {
+    close(fd);
+  }
   image.close();
   io_ctx.close();
   rados.shutdown();
@@ -2060,6 +2141,16 @@ static int parse_args(vector<const char*>& args, std::ostream *err_msg,
         return -EINVAL;
       }
       cfg->set_max_part = true;
+    } else if (ceph_argparse_witharg(args, i, &cfg->num_connections, err,
+                                     "--num-connections", (char *)NULL)) {
+      if (!err.str().empty()) {
+        *err_msg << "rbd-nbd: " << err.str();
+        return -EINVAL;
+      }
+      if (cfg->num_connections < 1) {
+        *err_msg << "rbd-nbd: Invalid argument for num-connections!";
+        return -EINVAL;
+      }
     } else if (ceph_argparse_flag(args, i, "--quiesce", (char *)NULL)) {
       cfg->quiesce = true;
     } else if (ceph_argparse_witharg(args, i, &cfg->quiesce_hook,
@@ -2203,6 +2294,12 @@ static int parse_args(vector<const char*>& args, std::ostream *err_msg,
     return -EINVAL;
   }
 
+  // the ioctl interface takes a single socket
+  if (cmd == Map && cfg->num_connections > 1 && !cfg->try_netlink) {
+    *err_msg << "rbd-nbd: --num-connections requires --try-netlink";
+    return -EINVAL;
+  }
+
   cfg->command = cmd;
   return 0;
 }